@@ -0,0 +1,159 @@
+//
+//  affinity.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_AFFINITY_H_
+#define YCSB_C_AFFINITY_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "log.h"
+#include "utils.h"
+
+namespace utils {
+
+///
+/// Parses a Linux CPU list such as "0-3,8,10-11".
+///
+inline std::vector<int> ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) end = list.size();
+    std::string range = Trim(list.substr(pos, end - pos));
+    pos = end + 1;
+    if (range.empty()) continue;
+    size_t dash = range.find('-');
+    try {
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ?
+          first : std::stoi(range.substr(dash + 1));
+      if (first < 0 || last < first) throw std::invalid_argument(range);
+      for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    } catch (const std::logic_error &) {
+      throw Exception("Invalid CPU list: " + list);
+    }
+  }
+  return cpus;
+}
+
+///
+/// Returns the CPUs this process may run on, grouped by NUMA node.
+/// Without NUMA information in sysfs, all CPUs form a single node.
+///
+inline std::vector<std::vector<int>> AllowedCpusByNode() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    throw Exception(std::string("sched_getaffinity: ") + strerror(errno));
+  }
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0; ; ++node) {
+    std::ifstream input("/sys/devices/system/node/node" +
+                        std::to_string(node) + "/cpulist");
+    if (!input) break;
+    std::string list;
+    std::getline(input, list);
+    std::vector<int> cpus;
+    for (int cpu : ParseCpuList(list)) {
+      if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+    }
+    if (!cpus.empty()) nodes.push_back(cpus);
+  }
+  if (nodes.empty()) {
+    nodes.resize(1);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) nodes[0].push_back(cpu);
+    }
+  }
+  return nodes;
+}
+
+///
+/// Maps each of num_threads client threads to a CPU according to policy:
+///   ""/"none": no pinning, and an empty result;
+///   "compact": fill the CPUs of one NUMA node before moving to the next;
+///   "scatter": alternate between NUMA nodes, one thread each in turn;
+///   otherwise a CPU list, e.g. "0-3,8", handed out in order.
+/// When there are more threads than CPUs, the CPUs are reused cyclically.
+///
+inline std::vector<int> ThreadCpus(const std::string &policy,
+                                   int num_threads) {
+  std::vector<int> cpus;
+  if (policy.empty() || policy == "none") return cpus;
+
+  if (policy == "compact" || policy == "scatter") {
+    std::vector<std::vector<int>> nodes = AllowedCpusByNode();
+    if (policy == "compact") {
+      for (const std::vector<int> &node : nodes) {
+        cpus.insert(cpus.end(), node.begin(), node.end());
+      }
+    } else {
+      for (size_t i = 0; ; ++i) {
+        bool any = false;
+        for (const std::vector<int> &node : nodes) {
+          if (i < node.size()) {
+            cpus.push_back(node[i]);
+            any = true;
+          }
+        }
+        if (!any) break;
+      }
+    }
+  } else {
+    cpus = ParseCpuList(policy);
+  }
+  if (cpus.empty()) throw Exception("No CPUs for affinity " + policy);
+
+  std::vector<int> assigned(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    assigned[i] = cpus[i % cpus.size()];
+  }
+  return assigned;
+}
+
+///
+/// Restricts the calling thread to run on cpu only.
+///
+inline void PinThisThread(int cpu) {
+  if (cpu >= CPU_SETSIZE) {
+    throw Exception("CPU " + std::to_string(cpu) + " is out of range");
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (err != 0) {
+    throw Exception("Cannot pin to CPU " + std::to_string(cpu) + ": " +
+                    strerror(err));
+  }
+}
+
+///
+/// Makes the calling thread allocate new pages on the NUMA node it runs on,
+/// overriding any process-wide policy such as numactl --interleave.
+/// Allocations are first-touch local by default already; this only matters
+/// when such a policy is set. Failure (e.g. a kernel without NUMA) is
+/// logged and otherwise ignored.
+///
+inline void SetLocalAllocation() {
+  const int kMpolLocal = 4; // MPOL_LOCAL from <linux/mempolicy.h>
+  if (syscall(SYS_set_mempolicy, kMpolLocal, NULL, 0) != 0) {
+    YCSB_LOG_WARN("set_mempolicy(MPOL_LOCAL): %s", strerror(errno));
+  }
+}
+
+} // utils
+
+#endif // YCSB_C_AFFINITY_H_
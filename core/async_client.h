@@ -0,0 +1,221 @@
+//
+//  async_client.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_ASYNC_CLIENT_H_
+#define YCSB_C_ASYNC_CLIENT_H_
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+#include "db.h"
+#include "core_workload.h"
+#include "measurements.h"
+#include "timer.h"
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Client that keeps up to queue_depth transactions of one thread in flight
+/// through the DB's Async methods. Each in-flight transaction has its own
+/// slot with its own buffers, and its latency is recorded when it completes.
+///
+class AsyncClient {
+ public:
+  AsyncClient(DB &db, CoreWorkload &wl, int queue_depth,
+              OpMeasurements *measurements = NULL,
+              OpMeasurements *intended_measurements = NULL);
+
+  ///
+  /// Submits the next transaction, first waiting for one to complete if
+  /// queue_depth are already in flight.
+  ///
+  void DoTransaction();
+
+  ///
+  /// Waits for every transaction in flight, and returns how many of those
+  /// submitted so far succeeded.
+  ///
+  int Drain();
+
+  ///
+  /// Sets the time at which the next transaction was scheduled to start,
+  /// as Client::set_intended_start() does.
+  ///
+  void set_intended_start(uint64_t ns) { intended_start_ns_ = ns; }
+
+  AsyncClient(const AsyncClient &) = delete;
+  AsyncClient &operator=(const AsyncClient &) = delete;
+
+ private:
+  class Slot : public DB::AsyncRequest {
+   public:
+    explicit Slot(AsyncClient &client) : client_(client) { }
+    void Complete(int status);
+
+    Operation op;
+    uint64_t start_ns;
+    uint64_t intended_start_ns;
+    uint64_t insert_key_num;  ///< For InsertDone() if op is INSERT
+    const std::vector<std::string> *fields;
+
+    std::string key;
+    std::vector<std::string> field_list;
+    std::vector<DB::KVPair> values;
+    std::vector<DB::KVPair> result;
+    std::vector<std::string> keys;
+    std::vector<std::vector<DB::KVPair>> results;
+
+   private:
+    AsyncClient &client_;
+  };
+
+  void Submit(Slot &slot);
+  void Finish(Slot &slot, int status);
+  void Wait(size_t num_free);
+
+  DB &db_;
+  CoreWorkload &workload_;
+  OpMeasurements *measurements_;
+  OpMeasurements *intended_measurements_;
+  uint64_t intended_start_ns_;
+  int oks_;
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::vector<Slot *> free_;
+};
+
+inline AsyncClient::AsyncClient(DB &db, CoreWorkload &wl, int queue_depth,
+    OpMeasurements *measurements, OpMeasurements *intended_measurements) :
+    db_(db), workload_(wl), measurements_(measurements),
+    intended_measurements_(intended_measurements), intended_start_ns_(0),
+    oks_(0) {
+  assert(queue_depth > 0);
+  for (int i = 0; i < queue_depth; ++i) {
+    slots_.emplace_back(new Slot(*this));
+    free_.push_back(slots_.back().get());
+  }
+}
+
+inline void AsyncClient::DoTransaction() {
+  Wait(1);
+  Slot &slot = *free_.back();
+  free_.pop_back();
+
+  slot.op = workload_.NextOperation();
+  slot.intended_start_ns = intended_start_ns_;
+  slot.fields = NULL;
+  switch (slot.op) {
+    case INSERT:
+      slot.insert_key_num = workload_.NextInsertKey(slot.key);
+      workload_.BuildValues(slot.values);
+      break;
+    case UPDATE:
+    case READMODIFYWRITE:
+      workload_.NextTransactionKey(slot.key);
+      if (workload_.write_all_fields()) {
+        workload_.BuildValues(slot.values);
+      } else {
+        workload_.BuildUpdate(slot.values);
+      }
+      break;
+    case MULTIREAD:
+      slot.keys.resize(workload_.multiread_batch_size());
+      for (std::string &key : slot.keys) {
+        workload_.NextTransactionKey(key);
+      }
+      break;
+    case DELETE:
+      workload_.NextDeleteKey(slot.key);
+      break;
+    default:
+      workload_.NextTransactionKey(slot.key);
+      break;
+  }
+  if (slot.op != INSERT && slot.op != UPDATE && slot.op != DELETE &&
+      !workload_.read_all_fields()) {
+    slot.field_list.resize(1);
+    slot.field_list[0] = workload_.NextFieldName();
+    slot.fields = &slot.field_list;
+  }
+
+  slot.result.clear();
+  slot.results.clear();
+  slot.start_ns = utils::NowNanos();
+  Submit(slot);
+}
+
+inline void AsyncClient::Submit(Slot &slot) {
+  const std::string &table = workload_.NextTable();
+  switch (slot.op) {
+    case READ:
+      db_.AsyncRead(table, slot.key, slot.fields, slot.result, &slot);
+      break;
+    case UPDATE:
+      db_.AsyncUpdate(table, slot.key, slot.values, &slot);
+      break;
+    case INSERT:
+      db_.AsyncInsert(table, slot.key, slot.values, &slot);
+      break;
+    case SCAN:
+      db_.AsyncScan(table, slot.key, workload_.NextScanLength(), slot.fields,
+                    slot.results, &slot);
+      break;
+    case READMODIFYWRITE:
+      db_.AsyncReadModifyWrite(table, slot.key, slot.fields, slot.result,
+                               slot.values, &slot);
+      break;
+    case MULTIREAD:
+      db_.AsyncMultiRead(table, slot.keys, slot.fields, slot.results, &slot);
+      break;
+    case DELETE:
+      db_.AsyncDelete(table, slot.key, &slot);
+      break;
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+}
+
+inline void AsyncClient::Slot::Complete(int status) {
+  client_.Finish(*this, status);
+}
+
+inline void AsyncClient::Finish(Slot &slot, int status) {
+  uint64_t end_ns = utils::NowNanos();
+  if (measurements_) {
+    measurements_->Report(slot.op, status, end_ns - slot.start_ns);
+  }
+  if (intended_measurements_ && slot.intended_start_ns) {
+    intended_measurements_->Report(slot.op, status,
+                                   end_ns - slot.intended_start_ns);
+  }
+  if (status == DB::kOK) {
+    if (slot.op == INSERT || slot.op == UPDATE) workload_.KeyWritten(slot.key);
+    if (slot.op == DELETE) workload_.KeyDeleted(slot.key);
+    ++oks_;
+  } else if (workload_.ExpectedMiss(slot.op, status, slot.key)) {
+    ++oks_; // Found nothing, as expected of a deleted record
+  }
+  if (slot.op == INSERT) workload_.InsertDone(slot.insert_key_num);
+  free_.push_back(&slot);
+}
+
+inline void AsyncClient::Wait(size_t num_free) {
+  while (free_.size() < num_free) {
+    if (db_.Poll(num_free - free_.size()) == 0) {
+      throw utils::Exception("DB::Poll() left requests outstanding");
+    }
+  }
+}
+
+inline int AsyncClient::Drain() {
+  Wait(slots_.size());
+  return oks_;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_ASYNC_CLIENT_H_
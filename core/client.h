@@ -12,16 +12,37 @@
 #include <string>
 #include "db.h"
 #include "core_workload.h"
+#include "log.h"
+#include "measurements.h"
+#include "timer.h"
 #include "utils.h"
 
 namespace ycsbc {
 
 class Client {
  public:
-  Client(DB &db, CoreWorkload &wl) : db_(db), workload_(wl) { }
+  Client(DB &db, CoreWorkload &wl, OpMeasurements *measurements = NULL,
+         OpMeasurements *intended_measurements = NULL) :
+      db_(db), workload_(wl), measurements_(measurements),
+      intended_measurements_(intended_measurements), intended_start_ns_(0) { }
   
   virtual bool DoInsert();
   virtual bool DoTransaction();
+
+  ///
+  /// Inserts the records numbered [first_key_num, first_key_num + n) with a
+  /// single DB::BatchInsert() call, whose latency is recorded as one
+  /// BATCHINSERT; a single record goes through DB::Insert() as an INSERT.
+  /// Returns the number of records inserted.
+  ///
+  virtual int DoBatchInsert(uint64_t first_key_num, size_t n);
+
+  ///
+  /// Sets the time at which the next operation was scheduled to start.
+  /// Under a target throughput its latency is then also recorded from this
+  /// point, so that time spent queued behind a slow operation is counted.
+  ///
+  void set_intended_start(uint64_t ns) { intended_start_ns_ = ns; }
   
   virtual ~Client() { }
   
@@ -32,22 +53,82 @@ class Client {
   virtual int TransactionScan();
   virtual int TransactionUpdate();
   virtual int TransactionInsert();
+  virtual int TransactionMultiRead();
+  virtual int TransactionDelete();
+
+  ///
+  /// Returns the single field to read, or NULL to read all fields.
+  ///
+  const std::vector<std::string> *NextReadFields();
+
+  ///
+  /// Records the latency of an operation started at start_ns and passes
+  /// its status through.
+  ///
+  int Measure(Operation op, uint64_t start_ns, int status) {
+    if (!measurements_ && !intended_measurements_) return status;
+    uint64_t end_ns = utils::NowNanos();
+    if (measurements_) {
+      measurements_->Report(op, status, end_ns - start_ns);
+    }
+    if (intended_measurements_ && intended_start_ns_) {
+      intended_measurements_->Report(op, status, end_ns - intended_start_ns_);
+    }
+    return status;
+  }
   
   DB &db_;
   CoreWorkload &workload_;
+  OpMeasurements *measurements_;
+  OpMeasurements *intended_measurements_;
+  uint64_t intended_start_ns_;
+
+  // Reused by every operation so that none allocates in steady state.
+  // Results are cleared before each call, as not every DB clears them.
+  std::string key_;
+  std::vector<std::string> fields_;
+  std::vector<DB::KVPair> values_;
+  std::vector<DB::KVPair> result_;
+  std::vector<std::vector<DB::KVPair>> scan_result_;
+  std::vector<std::string> batch_keys_;
+  std::vector<std::vector<DB::KVPair>> batch_values_; ///< Or multi-read results
 };
 
 inline bool Client::DoInsert() {
-  std::string key = workload_.NextSequenceKey();
-  std::vector<DB::KVPair> pairs;
-  workload_.BuildValues(pairs);
-  std::cout << "KEY: " << key << "  VALUE first: " << pairs[0].first << "  VALUE second: " << pairs[0].second << std::endl;
-  return (db_.Insert(workload_.NextTable(), key, pairs) == DB::kOK);
+  uint64_t key_num = workload_.NextInsertKey(key_);
+  workload_.BuildValues(values_);
+  YCSB_LOG_TRACE("insert %s %s=%s", key_.c_str(), values_[0].first.c_str(),
+                 values_[0].second.c_str());
+  const std::string &table = workload_.NextTable();
+  uint64_t start = utils::NowNanos();
+  int status = db_.Insert(table, key_, values_);
+  workload_.InsertDone(key_num);
+  return (Measure(INSERT, start, status) == DB::kOK);
+}
+
+inline int Client::DoBatchInsert(uint64_t first_key_num, size_t n) {
+  batch_keys_.resize(n);
+  batch_values_.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    workload_.SequenceKeyName(first_key_num + i, batch_keys_[i]);
+    workload_.BuildValues(batch_values_[i]);
+  }
+  const std::string &table = workload_.NextTable();
+  uint64_t start = utils::NowNanos();
+  if (n == 1) {
+    int status = db_.Insert(table, batch_keys_[0], batch_values_[0]);
+    return (Measure(INSERT, start, status) == DB::kOK ? 1 : 0);
+  }
+  size_t num_inserted = 0;
+  Measure(BATCHINSERT, start,
+          db_.BatchInsert(table, batch_keys_, batch_values_, &num_inserted));
+  return num_inserted;
 }
 
 inline bool Client::DoTransaction() {
   int status = -1;
-  switch (workload_.NextOperation()) {
+  Operation op = workload_.NextOperation();
+  switch (op) {
     case READ:
       status = TransactionRead();
       break;
@@ -63,81 +144,107 @@ inline bool Client::DoTransaction() {
     case READMODIFYWRITE:
       status = TransactionReadModifyWrite();
       break;
+    case MULTIREAD:
+      status = TransactionMultiRead();
+      break;
+    case DELETE:
+      status = TransactionDelete();
+      break;
     default:
       throw utils::Exception("Operation request is not recognized!");
   }
   assert(status >= 0);
-  return (status == DB::kOK);
+  return (status == DB::kOK || workload_.ExpectedMiss(op, status, key_));
+}
+
+inline const std::vector<std::string> *Client::NextReadFields() {
+  if (workload_.read_all_fields()) return NULL;
+  fields_.resize(1);
+  fields_[0] = workload_.NextFieldName();
+  return &fields_;
 }
 
 inline int Client::TransactionRead() {
   const std::string &table = workload_.NextTable();
-  const std::string &key = workload_.NextTransactionKey();
-  std::vector<DB::KVPair> result;
-  if (!workload_.read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back("field" + workload_.NextFieldName());
-    return db_.Read(table, key, &fields, result);
-  } else {
-    return db_.Read(table, key, NULL, result);
-  }
+  workload_.NextTransactionKey(key_);
+  const std::vector<std::string> *fields = NextReadFields();
+  result_.clear();
+  uint64_t start = utils::NowNanos();
+  return Measure(READ, start, db_.Read(table, key_, fields, result_));
 }
 
 inline int Client::TransactionReadModifyWrite() {
   const std::string &table = workload_.NextTable();
-  const std::string &key = workload_.NextTransactionKey();
-  std::vector<DB::KVPair> result;
-
-  if (!workload_.read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back("field" + workload_.NextFieldName());
-    db_.Read(table, key, &fields, result);
-  } else {
-    db_.Read(table, key, NULL, result);
-  }
-
-  std::vector<DB::KVPair> values;
+  workload_.NextTransactionKey(key_);
+  const std::vector<std::string> *fields = NextReadFields();
   if (workload_.write_all_fields()) {
-    workload_.BuildValues(values);
+    workload_.BuildValues(values_);
   } else {
-    workload_.BuildUpdate(values);
+    workload_.BuildUpdate(values_);
   }
-  return db_.Update(table, key, values);
+  result_.clear();
+  uint64_t start = utils::NowNanos();
+  return Measure(READMODIFYWRITE, start,
+                 db_.ReadModifyWrite(table, key_, fields, result_, values_));
 }
 
 inline int Client::TransactionScan() {
   const std::string &table = workload_.NextTable();
-  const std::string &key = workload_.NextTransactionKey();
+  workload_.NextTransactionKey(key_);
   int len = workload_.NextScanLength();
-  std::vector<std::vector<DB::KVPair>> result;
-  if (!workload_.read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back("field" + workload_.NextFieldName());
-    return db_.Scan(table, key, len, &fields, result);
-  } else {
-    return db_.Scan(table, key, len, NULL, result);
-  }
+  const std::vector<std::string> *fields = NextReadFields();
+  scan_result_.clear();
+  uint64_t start = utils::NowNanos();
+  return Measure(SCAN, start,
+                 db_.Scan(table, key_, len, fields, scan_result_));
 }
 
 inline int Client::TransactionUpdate() {
   const std::string &table = workload_.NextTable();
-  const std::string &key = workload_.NextTransactionKey();
-  std::vector<DB::KVPair> values;
+  workload_.NextTransactionKey(key_);
   if (workload_.write_all_fields()) {
-    workload_.BuildValues(values);
+    workload_.BuildValues(values_);
   } else {
-    workload_.BuildUpdate(values);
+    workload_.BuildUpdate(values_);
   }
-  return db_.Update(table, key, values);
+  uint64_t start = utils::NowNanos();
+  int status = Measure(UPDATE, start, db_.Update(table, key_, values_));
+  if (status == DB::kOK) workload_.KeyWritten(key_);
+  return status;
 }
 
 inline int Client::TransactionInsert() {
   const std::string &table = workload_.NextTable();
-  const std::string &key = workload_.NextSequenceKey();
-  std::vector<DB::KVPair> values;
-  workload_.BuildValues(values);
-  return db_.Insert(table, key, values);
-} 
+  uint64_t key_num = workload_.NextInsertKey(key_);
+  workload_.BuildValues(values_);
+  uint64_t start = utils::NowNanos();
+  int status = Measure(INSERT, start, db_.Insert(table, key_, values_));
+  if (status == DB::kOK) workload_.KeyWritten(key_);
+  workload_.InsertDone(key_num);
+  return status;
+}
+
+inline int Client::TransactionMultiRead() {
+  const std::string &table = workload_.NextTable();
+  batch_keys_.resize(workload_.multiread_batch_size());
+  for (std::string &key : batch_keys_) {
+    workload_.NextTransactionKey(key);
+  }
+  const std::vector<std::string> *fields = NextReadFields();
+  batch_values_.clear();
+  uint64_t start = utils::NowNanos();
+  return Measure(MULTIREAD, start,
+                 db_.MultiRead(table, batch_keys_, fields, batch_values_));
+}
+
+inline int Client::TransactionDelete() {
+  const std::string &table = workload_.NextTable();
+  workload_.NextDeleteKey(key_);
+  uint64_t start = utils::NowNanos();
+  int status = Measure(DELETE, start, db_.Delete(table, key_));
+  if (status == DB::kOK) workload_.KeyDeleted(key_);
+  return status;
+}
 
 } // ycsbc
 
@@ -10,9 +10,13 @@
 #include "zipfian_generator.h"
 #include "scrambled_zipfian_generator.h"
 #include "skewed_latest_generator.h"
+#include "hotspot_generator.h"
+#include "sequential_generator.h"
+#include "exponential_generator.h"
 #include "const_generator.h"
 #include "core_workload.h"
 
+#include <algorithm>
 #include <string>
 
 using ycsbc::CoreWorkload;
@@ -28,6 +32,11 @@ const string CoreWorkload::FIELD_LENGTH_DISTRIBUTION_PROPERTY =
     "field_len_dist";
 const string CoreWorkload::FIELD_LENGTH_DISTRIBUTION_DEFAULT = "constant";
 
+const string CoreWorkload::FIELD_LENGTH_HISTOGRAM_PROPERTY =
+    "field_len_histogram";
+
+const string CoreWorkload::KEY_LENGTH_HISTOGRAM_PROPERTY = "key_len_histogram";
+
 const string CoreWorkload::FIELD_LENGTH_PROPERTY = "fieldlength";
 const string CoreWorkload::FIELD_LENGTH_DEFAULT = "100";
 
@@ -53,10 +62,38 @@ const string CoreWorkload::READMODIFYWRITE_PROPORTION_PROPERTY =
     "readmodifywriteproportion";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_DEFAULT = "0.0";
 
+const string CoreWorkload::MULTIREAD_PROPORTION_PROPERTY =
+    "multireadproportion";
+const string CoreWorkload::MULTIREAD_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::DELETE_PROPORTION_PROPERTY = "deleteproportion";
+const string CoreWorkload::DELETE_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::DELETE_ORDER_PROPERTY = "deleteorder";
+const string CoreWorkload::DELETE_ORDER_DEFAULT = "oldest";
+
+const string CoreWorkload::MULTIREAD_BATCH_SIZE_PROPERTY = "multireadbatchsize";
+const string CoreWorkload::MULTIREAD_BATCH_SIZE_DEFAULT = "10";
+
 const string CoreWorkload::REQUEST_DISTRIBUTION_PROPERTY =
     "requestdistribution";
 const string CoreWorkload::REQUEST_DISTRIBUTION_DEFAULT = "uniform";
 
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_PROPERTY =
+    "hotspotdatafraction";
+const string CoreWorkload::HOTSPOT_DATA_FRACTION_DEFAULT = "0.2";
+
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_PROPERTY =
+    "hotspotopnfraction";
+const string CoreWorkload::HOTSPOT_OPN_FRACTION_DEFAULT = "0.8";
+
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_PROPERTY =
+    "exponential.percentile";
+const string CoreWorkload::EXPONENTIAL_PERCENTILE_DEFAULT = "95";
+
+const string CoreWorkload::EXPONENTIAL_FRAC_PROPERTY = "exponential.frac";
+const string CoreWorkload::EXPONENTIAL_FRAC_DEFAULT = "0.8571428571";
+
 const string CoreWorkload::ZERO_PADDING_PROPERTY = "zeropadding";
 const string CoreWorkload::ZERO_PADDING_DEFAULT = "1";
 
@@ -73,6 +110,12 @@ const string CoreWorkload::INSERT_ORDER_DEFAULT = "hashed";
 const string CoreWorkload::INSERT_START_PROPERTY = "insertstart";
 const string CoreWorkload::INSERT_START_DEFAULT = "0";
 
+const string CoreWorkload::VALUE_POOL_PROPERTY = "valuepool";
+const string CoreWorkload::VALUE_POOL_DEFAULT = "false";
+
+const string CoreWorkload::VALUE_POOL_SIZE_PROPERTY = "valuepoolsize";
+const string CoreWorkload::VALUE_POOL_SIZE_DEFAULT = "16777216";
+
 const string CoreWorkload::RECORD_COUNT_PROPERTY = "recordcount";
 const string CoreWorkload::OPERATION_COUNT_PROPERTY = "operationcount";
 
@@ -81,7 +124,26 @@ void CoreWorkload::Init(const utils::Properties &p) {
   
   field_count_ = std::stoi(p.GetProperty(FIELD_COUNT_PROPERTY,
                                          FIELD_COUNT_DEFAULT));
+  field_names_.clear();
+  for (int i = 0; i < field_count_; ++i) {
+    field_names_.push_back(std::string("field").append(std::to_string(i)));
+  }
   field_len_generator_ = GetFieldLenGenerator(p);
+
+  delete value_pool_;
+  value_pool_ = NULL;
+  if (utils::StrToBool(p.GetProperty(VALUE_POOL_PROPERTY,
+                                     VALUE_POOL_DEFAULT))) {
+    size_t pool_size = std::stoull(p.GetProperty(VALUE_POOL_SIZE_PROPERTY,
+                                                 VALUE_POOL_SIZE_DEFAULT));
+    size_t max_len = std::stoull(p.GetProperty(FIELD_LENGTH_PROPERTY,
+                                               FIELD_LENGTH_DEFAULT));
+    EmpiricalGenerator *histogram =
+        dynamic_cast<EmpiricalGenerator *>(field_len_generator_);
+    if (histogram) max_len = histogram->max_value();
+    // Leave room for the cursor to move even for the longest value
+    value_pool_ = new ValuePool(std::max(pool_size, 2 * max_len + 1));
+  }
   
   double read_proportion = std::stod(p.GetProperty(READ_PROPORTION_PROPERTY,
                                                    READ_PROPORTION_DEFAULT));
@@ -93,11 +155,27 @@ void CoreWorkload::Init(const utils::Properties &p) {
                                                    SCAN_PROPORTION_DEFAULT));
   double readmodifywrite_proportion = std::stod(p.GetProperty(
       READMODIFYWRITE_PROPORTION_PROPERTY, READMODIFYWRITE_PROPORTION_DEFAULT));
+  double multiread_proportion = std::stod(p.GetProperty(
+      MULTIREAD_PROPORTION_PROPERTY, MULTIREAD_PROPORTION_DEFAULT));
+  double delete_proportion = std::stod(p.GetProperty(
+      DELETE_PROPORTION_PROPERTY, DELETE_PROPORTION_DEFAULT));
+  multiread_batch_size_ = std::stoul(p.GetProperty(
+      MULTIREAD_BATCH_SIZE_PROPERTY, MULTIREAD_BATCH_SIZE_DEFAULT));
+  if (multiread_proportion > 0 && multiread_batch_size_ == 0) {
+    throw utils::Exception("multireadbatchsize must be positive");
+  }
   
   record_count_ = std::stoi(p.GetProperty(RECORD_COUNT_PROPERTY));
   std::string request_dist = p.GetProperty(REQUEST_DISTRIBUTION_PROPERTY,
                                            REQUEST_DISTRIBUTION_DEFAULT);
   zero_padding_ = std::stoi(p.GetProperty(ZERO_PADDING_PROPERTY, ZERO_PADDING_DEFAULT));
+  delete key_len_chooser_;
+  key_len_chooser_ = NULL;
+  std::string key_len_file = p.GetProperty(KEY_LENGTH_HISTOGRAM_PROPERTY);
+  if (!key_len_file.empty()) {
+    key_len_chooser_ = new EmpiricalGenerator(
+        EmpiricalGenerator::LoadBuckets(key_len_file));
+  }
   int max_scan_len = std::stoi(p.GetProperty(MAX_SCAN_LENGTH_PROPERTY,
                                              MAX_SCAN_LENGTH_DEFAULT));
   std::string scan_len_dist = p.GetProperty(SCAN_LENGTH_DISTRIBUTION_PROPERTY,
@@ -116,7 +194,7 @@ void CoreWorkload::Init(const utils::Properties &p) {
     ordered_inserts_ = true;
   }
   
-  key_generator_ = new CounterGenerator(insert_start);
+  key_generator_ = new AcknowledgedCounterGenerator(insert_start);
   
   if (read_proportion > 0) {
     op_chooser_.AddValue(READ, read_proportion);
@@ -133,8 +211,13 @@ void CoreWorkload::Init(const utils::Properties &p) {
   if (readmodifywrite_proportion > 0) {
     op_chooser_.AddValue(READMODIFYWRITE, readmodifywrite_proportion);
   }
-  
-  insert_key_sequence_.Set(record_count_);
+  if (multiread_proportion > 0) {
+    op_chooser_.AddValue(MULTIREAD, multiread_proportion);
+  }
+  if (delete_proportion > 0) {
+    op_chooser_.AddValue(DELETE, delete_proportion);
+    deleted_keys_.reset(new DeletedKeys);
+  }
   
   if (request_dist == "uniform") {
     key_chooser_ = new UniformGenerator(0, record_count_ - 1);
@@ -150,12 +233,47 @@ void CoreWorkload::Init(const utils::Properties &p) {
     key_chooser_ = new ScrambledZipfianGenerator(record_count_ + new_keys);
     
   } else if (request_dist == "latest") {
-    key_chooser_ = new SkewedLatestGenerator(insert_key_sequence_);
+    key_chooser_ = new SkewedLatestGenerator(*key_generator_, record_count_);
+    
+  } else if (request_dist == "hotspot") {
+    double hot_set = std::stod(p.GetProperty(HOTSPOT_DATA_FRACTION_PROPERTY,
+                                             HOTSPOT_DATA_FRACTION_DEFAULT));
+    double hot_ops = std::stod(p.GetProperty(HOTSPOT_OPN_FRACTION_PROPERTY,
+                                             HOTSPOT_OPN_FRACTION_DEFAULT));
+    if (hot_set < 0 || hot_set > 1 || hot_ops < 0 || hot_ops > 1) {
+      throw utils::Exception("Hotspot fractions must be within [0, 1]");
+    }
+    key_chooser_ = new HotspotGenerator(0, record_count_ - 1,
+                                        hot_set, hot_ops);
+    
+  } else if (request_dist == "sequential") {
+    key_chooser_ = new SequentialGenerator(0, record_count_ - 1);
+    
+  } else if (request_dist == "exponential") {
+    double percentile = std::stod(p.GetProperty(
+        EXPONENTIAL_PERCENTILE_PROPERTY, EXPONENTIAL_PERCENTILE_DEFAULT));
+    double frac = std::stod(p.GetProperty(EXPONENTIAL_FRAC_PROPERTY,
+                                          EXPONENTIAL_FRAC_DEFAULT));
+    if (percentile <= 0 || percentile >= 100 || frac <= 0) {
+      throw utils::Exception("exponential.percentile must be within (0, 100)"
+                             " and exponential.frac positive");
+    }
+    key_chooser_ = new ExponentialGenerator(percentile, record_count_ * frac);
+    latest_relative_ = true;
     
   } else {
     throw utils::Exception("Unknown request distribution: " + request_dist);
   }
   
+  std::string delete_order = p.GetProperty(DELETE_ORDER_PROPERTY,
+                                          DELETE_ORDER_DEFAULT);
+  if (delete_order != "oldest" && delete_order != "uniform") {
+    throw utils::Exception("Unknown delete order: " + delete_order);
+  }
+  delete_oldest_ = (delete_order == "oldest");
+  delete_cursor_.store(insert_start);
+  delete_chooser_ = new UniformGenerator(0, record_count_ - 1);
+
   field_chooser_ = new UniformGenerator(0, field_count_ - 1);
   
   if (scan_len_dist == "uniform") {
@@ -180,6 +298,9 @@ ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
     return new UniformGenerator(1, field_len);
   } else if(field_len_dist == "zipfian") {
     return new ZipfianGenerator(1, field_len);
+  } else if(field_len_dist == "histogram") {
+    return new EmpiricalGenerator(EmpiricalGenerator::LoadBuckets(
+        p.GetProperty(FIELD_LENGTH_HISTOGRAM_PROPERTY)));
   } else {
     throw utils::Exception("Unknown field length distribution: " +
         field_len_dist);
@@ -187,18 +308,27 @@ ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
 }
 
 void CoreWorkload::BuildValues(std::vector<ycsbc::DB::KVPair> &values) {
+  values.resize(field_count_);
   for (int i = 0; i < field_count_; ++i) {
-    ycsbc::DB::KVPair pair;
-    pair.first.append("field").append(std::to_string(i));
-    pair.second.append(field_len_generator_->Next(), utils::RandomPrintChar());
-    values.push_back(pair);
+    ycsbc::DB::KVPair &pair = values[i];
+    pair.first = field_names_[i];
+    FillValue(pair.second);
   }
 }
 
 void CoreWorkload::BuildUpdate(std::vector<ycsbc::DB::KVPair> &update) {
-  ycsbc::DB::KVPair pair;
-  pair.first.append(NextFieldName());
-  pair.second.append(field_len_generator_->Next(), utils::RandomPrintChar());
-  update.push_back(pair);
+  update.resize(1);
+  ycsbc::DB::KVPair &pair = update[0];
+  pair.first = NextFieldName();
+  FillValue(pair.second);
+}
+
+void CoreWorkload::FillValue(std::string &value, size_t len) {
+  if (value_pool_ && len < value_pool_->size()) {
+    value_pool_->Fill(value, len);
+  } else {
+    value.resize(len);
+    utils::RandomPrintChars(&value[0], len);
+  }
 }
 
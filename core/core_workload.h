@@ -9,13 +9,18 @@
 #ifndef YCSB_C_CORE_WORKLOAD_H_
 #define YCSB_C_CORE_WORKLOAD_H_
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <string>
 #include "db.h"
+#include "deleted_keys.h"
 #include "properties.h"
 #include "generator.h"
 #include "discrete_generator.h"
 #include "counter_generator.h"
+#include "empirical_generator.h"
+#include "value_pool.h"
 #include "utils.h"
 
 namespace ycsbc {
@@ -25,9 +30,21 @@ enum Operation {
   READ,
   UPDATE,
   SCAN,
-  READMODIFYWRITE
+  READMODIFYWRITE,
+  MULTIREAD,
+  DELETE,
+  BATCHINSERT,   ///< One DB::BatchInsert() of a load; never drawn
+  NUM_OPERATIONS ///< Number of operation types; not a valid operation
 };
 
+inline const char *OperationName(Operation op) {
+  static const char *names[NUM_OPERATIONS] = {
+    "INSERT", "READ", "UPDATE", "SCAN", "READMODIFYWRITE", "MULTIREAD",
+    "DELETE", "BATCHINSERT"
+  };
+  return names[op];
+}
+
 class CoreWorkload {
  public:
   /// 
@@ -44,10 +61,25 @@ class CoreWorkload {
   
   /// 
   /// The name of the property for the field length distribution.
-  /// Options are "uniform", "zipfian" (favoring short records), and "constant".
+  /// Options are "uniform", "zipfian" (favoring short records), "constant"
+  /// and "histogram".
   ///
   static const std::string FIELD_LENGTH_DISTRIBUTION_PROPERTY;
   static const std::string FIELD_LENGTH_DISTRIBUTION_DEFAULT;
+
+  ///
+  /// The name of the property for the file of "size weight" lines that the
+  /// "histogram" field length distribution samples.
+  ///
+  static const std::string FIELD_LENGTH_HISTOGRAM_PROPERTY;
+
+  ///
+  /// The name of the property for a file of the same form giving the
+  /// distribution of key lengths, including the "user" prefix. Each key
+  /// number always gets the same length; keys do not get shorter than their
+  /// digits need. Overrides zeropadding.
+  ///
+  static const std::string KEY_LENGTH_HISTOGRAM_PROPERTY;
   
   /// 
   /// The name of the property for the length of a field in bytes.
@@ -99,13 +131,62 @@ class CoreWorkload {
   ///
   static const std::string READMODIFYWRITE_PROPORTION_PROPERTY;
   static const std::string READMODIFYWRITE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of multi-read transactions,
+  /// each of which reads several records with one DB::MultiRead() call.
+  ///
+  static const std::string MULTIREAD_PROPORTION_PROPERTY;
+  static const std::string MULTIREAD_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the proportion of delete transactions.
+  ///
+  static const std::string DELETE_PROPORTION_PROPERTY;
+  static const std::string DELETE_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for which records deletes remove. Options are
+  /// "oldest", in the order they were inserted like an expiry policy, and
+  /// "uniform", any loaded record at random. Once every inserted record is
+  /// gone, "oldest" falls back to "uniform".
+  ///
+  static const std::string DELETE_ORDER_PROPERTY;
+  static const std::string DELETE_ORDER_DEFAULT;
+
+  ///
+  /// The name of the property for the number of keys in a multi-read.
+  ///
+  static const std::string MULTIREAD_BATCH_SIZE_PROPERTY;
+  static const std::string MULTIREAD_BATCH_SIZE_DEFAULT;
   
   /// 
   /// The name of the property for the the distribution of request keys.
-  /// Options are "uniform", "zipfian" and "latest".
+  /// Options are "uniform", "zipfian", "latest", "hotspot", "sequential"
+  /// and "exponential".
   ///
   static const std::string REQUEST_DISTRIBUTION_PROPERTY;
   static const std::string REQUEST_DISTRIBUTION_DEFAULT;
+
+  ///
+  /// The names of the properties for the "hotspot" distribution: the
+  /// fraction of the records in the hot set, and the fraction of the
+  /// operations that go to it.
+  ///
+  static const std::string HOTSPOT_DATA_FRACTION_PROPERTY;
+  static const std::string HOTSPOT_DATA_FRACTION_DEFAULT;
+  static const std::string HOTSPOT_OPN_FRACTION_PROPERTY;
+  static const std::string HOTSPOT_OPN_FRACTION_DEFAULT;
+
+  ///
+  /// The names of the properties for the "exponential" distribution:
+  /// exponential.percentile percent of the operations go to the
+  /// exponential.frac of the records inserted most recently.
+  ///
+  static const std::string EXPONENTIAL_PERCENTILE_PROPERTY;
+  static const std::string EXPONENTIAL_PERCENTILE_DEFAULT;
+  static const std::string EXPONENTIAL_FRAC_PROPERTY;
+  static const std::string EXPONENTIAL_FRAC_DEFAULT;
   
   ///
   /// The name of the property for adding zero padding to record numbers in order to match 
@@ -137,6 +218,19 @@ class CoreWorkload {
   static const std::string INSERT_START_PROPERTY;
   static const std::string INSERT_START_DEFAULT;
   
+  ///
+  /// The name of the property for copying values out of a pre-generated
+  /// random arena rather than generating each value byte by byte.
+  ///
+  static const std::string VALUE_POOL_PROPERTY;
+  static const std::string VALUE_POOL_DEFAULT;
+
+  ///
+  /// The name of the property for the size in bytes of that arena.
+  ///
+  static const std::string VALUE_POOL_SIZE_PROPERTY;
+  static const std::string VALUE_POOL_SIZE_DEFAULT;
+
   static const std::string RECORD_COUNT_PROPERTY;
   static const std::string OPERATION_COUNT_PROPERTY;
 
@@ -146,24 +240,121 @@ class CoreWorkload {
   ///
   virtual void Init(const utils::Properties &p);
   
+  ///
+  /// Fills values with a full record, or with a single random field for
+  /// BuildUpdate(). Existing elements are overwritten in place, so passing
+  /// the same vector again reuses its memory.
+  ///
   virtual void BuildValues(std::vector<ycsbc::DB::KVPair> &values);
   virtual void BuildUpdate(std::vector<ycsbc::DB::KVPair> &update);
   
-  virtual std::string NextTable() { return table_name_; }
+  virtual const std::string &NextTable() { return table_name_; }
   virtual std::string NextSequenceKey(); /// Used for loading data
   virtual std::string NextTransactionKey(); /// Used for transactions
+  ///
+  /// Like the above, but format into key, whose capacity is then reused
+  /// by later calls instead of allocating a new string per operation.
+  ///
+  virtual void NextSequenceKey(std::string &key);
+  virtual void NextTransactionKey(std::string &key);
+  ///
+  /// Formats into key the record a transaction inserts, and returns the
+  /// number to pass to InsertDone() once the DB has answered, successfully
+  /// or not. Only then do transactions pick that record and the ones after.
+  ///
+  virtual uint64_t NextInsertKey(std::string &key);
+  virtual void InsertDone(uint64_t key_num) {
+    key_generator_->Acknowledge(key_num);
+  }
+  virtual void NextDeleteKey(std::string &key);
   virtual Operation NextOperation() { return op_chooser_.Next(); }
-  virtual std::string NextFieldName();
+  virtual const std::string &NextFieldName();
   virtual size_t NextScanLength() { return scan_len_chooser_->Next(); }
+
+  ///
+  /// Numeric forms of the above, for callers that record operations rather
+  /// than execute them. Key numbers are already scrambled for hashed inserts,
+  /// so FormatKeyName() turns them into the same keys as the string forms.
+  ///
+  uint64_t NextSequenceKeyNum();
+  uint64_t NextTransactionKeyNum();
+  uint64_t NextDeleteKeyNum();
+  uint64_t NextFieldIndex() { return field_chooser_->Next(); }
+  uint64_t NextFieldLength() { return field_len_generator_->Next(); }
+
+  ///
+  /// One past the last key number, before scrambling, below which every
+  /// insert has completed; after a phase, the key the next one inserts.
+  ///
+  uint64_t sequence_key_position() { return key_generator_->Last() + 1; }
+
+  ///
+  /// Reserves the next n insert key numbers for a caller that formats them
+  /// itself with SequenceKeyName(), e.g. to give each loading thread a
+  /// contiguous range. Returns the first one. The keys count as inserted at
+  /// once, so this is for loading before any transaction runs.
+  ///
+  uint64_t ReserveSequenceKeyNums(uint64_t n) {
+    return key_generator_->NextAcknowledged(n);
+  }
+  void SequenceKeyName(uint64_t key_num, std::string &key) const {
+    KeyName(ScrambleKeyNum(key_num), key);
+  }
+
+  ///
+  /// Tracks the records deleted by this workload, and by those it inherits
+  /// them from, once the DB has acknowledged it. KeyWritten() is for a
+  /// successful insert or update, since a DB may upsert a missing record.
+  ///
+  void KeyDeleted(const std::string &key) {
+    if (deleted_keys_) deleted_keys_->Add(key);
+  }
+  void KeyWritten(const std::string &key) {
+    if (deleted_keys_) deleted_keys_->Remove(key);
+  }
+  bool IsDeleted(const std::string &key) const {
+    return deleted_keys_ && deleted_keys_->Contains(key);
+  }
+
+  ///
+  /// Whether op failed only because it read or deleted key, a record
+  /// deleted earlier, and found nothing as it should.
+  ///
+  bool ExpectedMiss(Operation op, int status, const std::string &key) const {
+    return (op == READ || op == READMODIFYWRITE || op == DELETE) &&
+        (status == DB::kErrorNoData || status == DB::kNotFound) &&
+        IsDeleted(key);
+  }
+
+  ///
+  /// Continues the deletes of a workload that ran before this one on the
+  /// same DB: shares its record of deleted keys, and removes the oldest
+  /// records from where it stopped.
+  ///
+  void InheritDeletes(const CoreWorkload &previous) {
+    if (previous.deleted_keys_) deleted_keys_ = previous.deleted_keys_;
+    delete_cursor_.store(previous.delete_cursor_.load());
+  }
+
+  static std::string FormatKeyName(uint64_t key_num, int zero_padding);
+  static void FormatKeyName(uint64_t key_num, int zero_padding,
+                            std::string &key);
   
+  size_t multiread_batch_size() const { return multiread_batch_size_; }
   bool read_all_fields() const { return read_all_fields_; }
   bool write_all_fields() const { return write_all_fields_; }
+  int field_count() const { return field_count_; }
+  int zero_padding() const { return zero_padding_; }
+  bool varies_key_length() const { return key_len_chooser_ != NULL; }
+  size_t record_count() const { return record_count_; }
 
   CoreWorkload() :
       field_count_(0), read_all_fields_(false), write_all_fields_(false),
       field_len_generator_(NULL), key_generator_(NULL), key_chooser_(NULL),
-      field_chooser_(NULL), scan_len_chooser_(NULL), insert_key_sequence_(3),
-      ordered_inserts_(true), record_count_(0) {
+      field_chooser_(NULL), scan_len_chooser_(NULL), ordered_inserts_(true),
+      latest_relative_(false), record_count_(0), multiread_batch_size_(0),
+      value_pool_(NULL), key_len_chooser_(NULL), delete_chooser_(NULL),
+      delete_oldest_(true), delete_cursor_(0) {
   }
   
   virtual ~CoreWorkload() {
@@ -172,26 +363,74 @@ class CoreWorkload {
     if (key_chooser_) delete key_chooser_;
     if (field_chooser_) delete field_chooser_;
     if (scan_len_chooser_) delete scan_len_chooser_;
+    if (value_pool_) delete value_pool_;
+    if (key_len_chooser_) delete key_len_chooser_;
+    if (delete_chooser_) delete delete_chooser_;
   }
   
  protected:
   static Generator<uint64_t> *GetFieldLenGenerator(const utils::Properties &p);
+  void FillValue(std::string &value) {
+    FillValue(value, field_len_generator_->Next());
+  }
+  void FillValue(std::string &value, size_t len);
   std::string BuildKeyName(uint64_t key_num);
+  ///
+  /// Formats an already scrambled key number, at the length the key length
+  /// distribution gives it if there is one.
+  ///
+  void KeyName(uint64_t key_num, std::string &key) const {
+    int padding = zero_padding_;
+    if (key_len_chooser_) {
+      padding = (int)key_len_chooser_->Sample(utils::Hash(key_num)) - 4;
+    }
+    FormatKeyName(key_num, padding, key);
+  }
+  uint64_t ScrambleKeyNum(uint64_t key_num) const {
+    return ordered_inserts_ ? key_num : utils::Hash(key_num);
+  }
+  ///
+  /// Picks a key number from the request distribution among the records
+  /// whose insert has completed, drawing again for one that is not inserted
+  /// yet. Only after kMaxKeyDraws misses is a draw folded onto an inserted
+  /// key, so a stalled insert cannot make this loop. With latest_relative_
+  /// the draw counts back from the latest insert rather than up from zero.
+  ///
+  uint64_t ChooseInsertedKeyNum() {
+    const uint64_t limit = key_generator_->Last();
+    uint64_t key_num = key_chooser_->Next();
+    for (int i = 1; key_num > limit && i < kMaxKeyDraws; ++i) {
+      key_num = key_chooser_->Next();
+    }
+    if (key_num > limit) key_num %= limit + 1;
+    return latest_relative_ ? limit - key_num : key_num;
+  }
+
+  static const int kMaxKeyDraws = 16;
 
   std::string table_name_;
   int field_count_;
+  std::vector<std::string> field_names_; ///< "field0", "field1", ...
+
   bool read_all_fields_;
   bool write_all_fields_;
   Generator<uint64_t> *field_len_generator_;
-  Generator<uint64_t> *key_generator_;
+  AcknowledgedCounterGenerator *key_generator_;
   DiscreteGenerator<Operation> op_chooser_;
   Generator<uint64_t> *key_chooser_;
   Generator<uint64_t> *field_chooser_;
   Generator<uint64_t> *scan_len_chooser_;
-  CounterGenerator insert_key_sequence_;
   bool ordered_inserts_;
+  bool latest_relative_; ///< Whether key_chooser_ counts back from the latest
   size_t record_count_;
   int zero_padding_;
+  size_t multiread_batch_size_;
+  ValuePool *value_pool_; ///< NULL unless values are copied from a pool
+  EmpiricalGenerator *key_len_chooser_; ///< NULL for fixed zero padding
+  Generator<uint64_t> *delete_chooser_;
+  bool delete_oldest_;
+  std::atomic<uint64_t> delete_cursor_; ///< Oldest record not yet deleted
+  std::shared_ptr<DeletedKeys> deleted_keys_; ///< NULL if nothing deletes
 };
 
 inline std::string CoreWorkload::NextSequenceKey() {
@@ -200,25 +439,72 @@ inline std::string CoreWorkload::NextSequenceKey() {
 }
 
 inline std::string CoreWorkload::NextTransactionKey() {
-  uint64_t key_num;
-  do {
-    key_num = key_chooser_->Next();
-  } while (key_num > insert_key_sequence_.Last());
-  return BuildKeyName(key_num);
+  return BuildKeyName(ChooseInsertedKeyNum());
 }
 
-inline std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
-  if (!ordered_inserts_) {
-    key_num = utils::Hash(key_num);
+inline void CoreWorkload::NextSequenceKey(std::string &key) {
+  KeyName(NextSequenceKeyNum(), key);
+}
+
+inline void CoreWorkload::NextTransactionKey(std::string &key) {
+  KeyName(NextTransactionKeyNum(), key);
+}
+
+inline uint64_t CoreWorkload::NextSequenceKeyNum() {
+  return ScrambleKeyNum(key_generator_->Next());
+}
+
+inline uint64_t CoreWorkload::NextTransactionKeyNum() {
+  return ScrambleKeyNum(ChooseInsertedKeyNum());
+}
+
+inline uint64_t CoreWorkload::NextInsertKey(std::string &key) {
+  uint64_t key_num = key_generator_->Next();
+  SequenceKeyName(key_num, key);
+  return key_num;
+}
+
+inline void CoreWorkload::NextDeleteKey(std::string &key) {
+  KeyName(NextDeleteKeyNum(), key);
+}
+
+inline uint64_t CoreWorkload::NextDeleteKeyNum() {
+  if (delete_oldest_) {
+    uint64_t key_num = delete_cursor_.load(std::memory_order_relaxed);
+    while (key_num < sequence_key_position()) {
+      if (delete_cursor_.compare_exchange_weak(key_num, key_num + 1)) {
+        return ScrambleKeyNum(key_num);
+      }
+    }
   }
-  std::string key_num_str = std::to_string(key_num);
-  int zeros = zero_padding_ - key_num_str.length();
+  return ScrambleKeyNum(delete_chooser_->Next());
+}
+
+inline std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
+  std::string key;
+  KeyName(ScrambleKeyNum(key_num), key);
+  return key;
+}
+
+inline std::string CoreWorkload::FormatKeyName(uint64_t key_num,
+                                               int zero_padding) {
+  std::string key;
+  FormatKeyName(key_num, zero_padding, key);
+  return key;
+}
+
+inline void CoreWorkload::FormatKeyName(uint64_t key_num, int zero_padding,
+                                        std::string &key) {
+  char digits[utils::kMaxDecimalDigits];
+  char *end = digits + sizeof(digits);
+  char *begin = utils::FormatDecimal(key_num, end);
+  int zeros = zero_padding - (end - begin);
   zeros = std::max(0, zeros);
-  return std::string("user").append(zeros, '0').append(key_num_str);
+  key.assign("user", 4).append(zeros, '0').append(begin, end - begin);
 }
 
-inline std::string CoreWorkload::NextFieldName() {
-  return std::string("field").append(std::to_string(field_chooser_->Next()));
+inline const std::string &CoreWorkload::NextFieldName() {
+  return field_names_[NextFieldIndex()];
 }
   
 } // ycsbc
@@ -13,6 +13,8 @@
 
 #include <cstdint>
 #include <atomic>
+#include <memory>
+#include <thread>
 
 namespace ycsbc {
 
@@ -20,12 +22,79 @@ class CounterGenerator : public Generator<uint64_t> {
  public:
   CounterGenerator(uint64_t start) : counter_(start) { }
   uint64_t Next() { return counter_.fetch_add(1); }
+  ///
+  /// Takes n consecutive values at once and returns the first.
+  ///
+  uint64_t Next(uint64_t n) { return counter_.fetch_add(n); }
   uint64_t Last() { return counter_.load() - 1; }
   void Set(uint64_t start) { counter_.store(start); }
  private:
   std::atomic<uint64_t> counter_;
 };
 
+///
+/// Counter for keys inserted concurrently with reads of them. Last() is not
+/// the last value handed out but the highest one below which every value
+/// has been acknowledged, i.e. its insert has completed, so readers never
+/// pick a key still being inserted. Each acknowledged value is noted in a
+/// ring of kWindowSize slots, and the limit moves past a run of them by
+/// compare-and-swap, so neither Acknowledge() nor Last() takes a lock.
+///
+class AcknowledgedCounterGenerator : public CounterGenerator {
+ public:
+  static const uint64_t kWindowSize = 1 << 16;
+
+  explicit AcknowledgedCounterGenerator(uint64_t start) :
+      CounterGenerator(start), limit_(start - 1),
+      window_(new std::atomic<uint64_t>[kWindowSize]) {
+    for (uint64_t i = 0; i < kWindowSize; ++i) window_[i] = 0;
+  }
+
+  ///
+  /// Marks value, taken with Next(), as done. A value kWindowSize or more
+  /// past the limit yields until the ones before it catch up, which only
+  /// happens while the thread holding the oldest one is descheduled.
+  ///
+  void Acknowledge(uint64_t value);
+
+  ///
+  /// Takes n consecutive values that count as acknowledged at once, for a
+  /// bulk load that completes before anything reads. Must not be mixed with
+  /// outstanding Next() values.
+  ///
+  uint64_t NextAcknowledged(uint64_t n) {
+    uint64_t first = Next(n);
+    limit_.store(first + n - 1);
+    return first;
+  }
+
+  uint64_t Last() { return limit_.load(); }
+
+ private:
+  std::atomic<uint64_t> limit_;
+  /// Per slot, one past the last value acknowledged in it. Never cleared,
+  /// as a slot is only ever checked for the one value it may hold next.
+  std::unique_ptr<std::atomic<uint64_t>[]> window_;
+};
+
+inline void AcknowledgedCounterGenerator::Acknowledge(uint64_t value) {
+  // Sequentially consistent, so that of two threads acknowledging
+  // neighbouring values at once, at least one sees both
+  uint64_t limit = limit_.load();
+  while (value - limit >= kWindowSize) {
+    std::this_thread::yield();
+    limit = limit_.load();
+  }
+  window_[value % kWindowSize].store(value + 1);
+  // Whoever finds the value right past the limit acknowledged moves the
+  // limit onto it, whichever thread acknowledged it
+  for (;;) {
+    uint64_t next = limit + 1;
+    if (window_[next % kWindowSize].load() != next + 1) return;
+    if (limit_.compare_exchange_weak(limit, next)) limit = next;
+  }
+}
+
 } // ycsbc
 
 #endif // YCSB_C_COUNTER_GENERATOR_H_
@@ -46,6 +46,31 @@ class DB {
                    const std::vector<std::string> *fields,
                    std::vector<KVPair> &result) = 0;
   ///
+  /// Reads several records from the database.
+  /// The default implementation calls Read() once per key; backends that
+  /// can serve several keys with one request or one block read should
+  /// override it.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The keys of the records to read.
+  /// @param fields The list of fields to read, or NULL for all of them.
+  /// @param results For each key, a vector of field/value pairs.
+  /// @return Zero if every record was read, otherwise the error code of a
+  ///         record that was not.
+  ///
+  virtual int MultiRead(const std::string &table,
+                        const std::vector<std::string> &keys,
+                        const std::vector<std::string> *fields,
+                        std::vector<std::vector<KVPair>> &results) {
+    results.resize(keys.size());
+    int status = kOK;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      int s = Read(table, keys[i], fields, results[i]);
+      if (s != kOK) status = s;
+    }
+    return status;
+  }
+  ///
   /// Performs a range scan for a set of records in the database.
   /// Field/value pairs from the result are stored in a vector.
   ///
@@ -84,6 +109,33 @@ class DB {
   virtual int Insert(const std::string &table, const std::string &key,
                      std::vector<KVPair> &values) = 0;
   ///
+  /// Inserts several records into the database.
+  /// The default implementation calls Insert() once per record; backends
+  /// that can take a lock or write a log record once per batch should
+  /// override it.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The keys of the records to insert.
+  /// @param values For each key, the field/value pairs of its record.
+  /// @param num_inserted If not NULL, set to the number of records inserted.
+  /// @return Zero if every record was inserted, otherwise the error code of
+  ///         a record that failed.
+  ///
+  virtual int BatchInsert(const std::string &table,
+                          const std::vector<std::string> &keys,
+                          std::vector<std::vector<KVPair>> &values,
+                          size_t *num_inserted = NULL) {
+    int status = kOK;
+    size_t count = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      int s = Insert(table, keys[i], values[i]);
+      if (s != kOK) status = s;
+      else ++count;
+    }
+    if (num_inserted) *num_inserted = count;
+    return status;
+  }
+  ///
   /// Deletes a record from the database.
   ///
   /// @param table The name of the table.
@@ -91,6 +143,94 @@ class DB {
   /// @return Zero on success, a non-zero error code on error.
   ///
   virtual int Delete(const std::string &table, const std::string &key) = 0;
+  ///
+  /// Reads a record and then writes values to it. The default
+  /// implementation calls Read() and, only if it succeeds, Update().
+  ///
+  /// @param table The name of the table.
+  /// @param key The key of the record to read and write.
+  /// @param fields The list of fields to read, or NULL for all of them.
+  /// @param result A vector of field/value pairs for the read.
+  /// @param values A vector of field/value pairs to update in the record.
+  /// @return Zero on success, otherwise the error code of the read or the
+  ///         update, whichever failed.
+  ///
+  virtual int ReadModifyWrite(const std::string &table, const std::string &key,
+                              const std::vector<std::string> *fields,
+                              std::vector<KVPair> &result,
+                              std::vector<KVPair> &values) {
+    int status = Read(table, key, fields, result);
+    if (status != kOK) return status;
+    return Update(table, key, values);
+  }
+
+  ///
+  /// A request submitted through one of the Async methods below. The caller
+  /// owns it and keeps it, and everything it was submitted with, alive until
+  /// Complete() is called with the status the synchronous method would have
+  /// returned. That happens on the submitting thread, either within the
+  /// Async call itself or within a later Poll().
+  ///
+  class AsyncRequest {
+   public:
+    virtual void Complete(int status) = 0;
+   protected:
+    virtual ~AsyncRequest() { }
+  };
+  ///
+  /// Asynchronous forms of the methods above, for backends that can keep
+  /// several requests of one thread in flight. The defaults run the
+  /// synchronous method and complete the request before returning.
+  ///
+  virtual void AsyncRead(const std::string &table, const std::string &key,
+                         const std::vector<std::string> *fields,
+                         std::vector<KVPair> &result, AsyncRequest *request) {
+    request->Complete(Read(table, key, fields, result));
+  }
+  virtual void AsyncMultiRead(const std::string &table,
+                              const std::vector<std::string> &keys,
+                              const std::vector<std::string> *fields,
+                              std::vector<std::vector<KVPair>> &results,
+                              AsyncRequest *request) {
+    request->Complete(MultiRead(table, keys, fields, results));
+  }
+  virtual void AsyncScan(const std::string &table, const std::string &key,
+                         int record_count,
+                         const std::vector<std::string> *fields,
+                         std::vector<std::vector<KVPair>> &result,
+                         AsyncRequest *request) {
+    request->Complete(Scan(table, key, record_count, fields, result));
+  }
+  virtual void AsyncUpdate(const std::string &table, const std::string &key,
+                           std::vector<KVPair> &values,
+                           AsyncRequest *request) {
+    request->Complete(Update(table, key, values));
+  }
+  virtual void AsyncInsert(const std::string &table, const std::string &key,
+                           std::vector<KVPair> &values,
+                           AsyncRequest *request) {
+    request->Complete(Insert(table, key, values));
+  }
+  virtual void AsyncDelete(const std::string &table, const std::string &key,
+                           AsyncRequest *request) {
+    request->Complete(Delete(table, key));
+  }
+  virtual void AsyncReadModifyWrite(const std::string &table,
+                                    const std::string &key,
+                                    const std::vector<std::string> *fields,
+                                    std::vector<KVPair> &result,
+                                    std::vector<KVPair> &values,
+                                    AsyncRequest *request) {
+    request->Complete(ReadModifyWrite(table, key, fields, result, values));
+  }
+  ///
+  /// Waits until at least min_completions of the calling thread's
+  /// outstanding requests have completed, or none are left, calling
+  /// Complete() on each that did.
+  ///
+  /// @return The number of requests completed.
+  ///
+  virtual int Poll(int min_completions) { return 0; }
   
   virtual ~DB() { }
 };
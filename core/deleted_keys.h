@@ -0,0 +1,71 @@
+//
+//  deleted_keys.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_DELETED_KEYS_H_
+#define YCSB_C_DELETED_KEYS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace ycsbc {
+
+///
+/// The keys a run has deleted and not inserted again, so that reads of them
+/// can tell an expected miss from a lost record. Split into shards with a
+/// lock each; Contains() on an empty set takes no lock.
+///
+class DeletedKeys {
+ public:
+  DeletedKeys() : size_(0) { }
+
+  void Add(const std::string &key) {
+    Shard &shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.keys.insert(key).second) {
+      size_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void Remove(const std::string &key) {
+    if (size_.load(std::memory_order_relaxed) == 0) return;
+    Shard &shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.keys.erase(key)) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  bool Contains(const std::string &key) {
+    if (size_.load(std::memory_order_relaxed) == 0) return false;
+    Shard &shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.keys.count(key) != 0;
+  }
+
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  static const size_t kNumShards = 64;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_set<std::string> keys;
+  };
+
+  Shard &ShardOf(const std::string &key) {
+    return shards_[std::hash<std::string>()(key) % kNumShards];
+  }
+
+  Shard shards_[kNumShards];
+  std::atomic<size_t> size_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_DELETED_KEYS_H_
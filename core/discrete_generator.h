@@ -13,7 +13,6 @@
 
 #include <atomic>
 #include <cassert>
-#include <mutex>
 #include <vector>
 #include "utils.h"
 
@@ -29,10 +28,9 @@ class DiscreteGenerator : public Generator<Value> {
   Value Last() { return last_; }
 
  private:
-  std::vector<std::pair<Value, double>> values_;
+  std::vector<std::pair<Value, double>> values_; ///< Read-only after setup
   double sum_;
   std::atomic<Value> last_;
-  std::mutex mutex_;
 };
 
 template <typename Value>
@@ -46,13 +44,16 @@ inline void DiscreteGenerator<Value>::AddValue(Value value, double weight) {
 
 template <typename Value>
 inline Value DiscreteGenerator<Value>::Next() {
-  mutex_.lock();
   double chooser = utils::RandomDouble();
-  mutex_.unlock();
   
   for (auto p = values_.cbegin(); p != values_.cend(); ++p) {
     if (chooser < p->second / sum_) {
-      return last_ = p->first;
+      // Skip the store when unchanged so that client threads drawing the
+      // same operation do not keep invalidating each other's cache line.
+      if (last_.load(std::memory_order_relaxed) != p->first) {
+        last_.store(p->first, std::memory_order_relaxed);
+      }
+      return p->first;
     }
     chooser -= p->second / sum_;
   }
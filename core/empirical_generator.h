@@ -0,0 +1,151 @@
+//
+//  empirical_generator.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_EMPIRICAL_GENERATOR_H_
+#define YCSB_C_EMPIRICAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Generates sizes following a measured histogram. Each bucket is a size,
+/// or an inclusive range of sizes drawn uniformly, with a weight. Buckets
+/// are picked in O(1) with Vose's alias method: one uniform column choice
+/// and one biased coin per value. Can be shared by all client threads.
+///
+class EmpiricalGenerator : public Generator<uint64_t> {
+ public:
+  struct Bucket {
+    uint64_t min;
+    uint64_t max;
+    double weight;
+  };
+
+  explicit EmpiricalGenerator(const std::vector<Bucket> &buckets);
+
+  ///
+  /// Loads buckets from a file with one "size weight" or "min-max weight"
+  /// pair per line; blank lines and lines starting with '#' are skipped.
+  ///
+  static std::vector<Bucket> LoadBuckets(const std::string &path);
+
+  uint64_t Next() {
+    uint64_t value = Sample(utils::ThreadLocalRandom()());
+    last_.Set(value);
+    return value;
+  }
+
+  uint64_t Last() { return last_.Get(); }
+
+  ///
+  /// Maps 64 random bits to a value, so that the same bits always give the
+  /// same value; e.g. a hash of a key number gives that key a fixed size.
+  ///
+  uint64_t Sample(uint64_t bits) const;
+
+  uint64_t max_value() const { return max_value_; }
+
+ private:
+  std::vector<Bucket> buckets_;
+  std::vector<uint32_t> prob_;  ///< Chance of keeping a column, in 2^-32
+  std::vector<uint32_t> alias_; ///< Bucket taken otherwise
+  uint64_t max_value_;
+  ThreadLastValue last_;
+};
+
+inline EmpiricalGenerator::EmpiricalGenerator(
+    const std::vector<Bucket> &buckets) :
+    buckets_(buckets), prob_(buckets.size()), alias_(buckets.size()),
+    max_value_(0), last_(0) {
+  const size_t n = buckets_.size();
+  double total = 0;
+  for (const Bucket &b : buckets_) {
+    if (b.weight < 0 || b.min > b.max) {
+      throw utils::Exception("Invalid histogram bucket");
+    }
+    total += b.weight;
+    max_value_ = std::max(max_value_, b.max);
+  }
+  if (n == 0 || n > UINT32_MAX || total <= 0) {
+    throw utils::Exception("Histogram has no weight");
+  }
+
+  // Scale so that the average column holds 1, then let every column below
+  // 1 be topped up by one above it.
+  std::vector<double> scaled(n);
+  std::vector<uint32_t> small, large;
+  for (size_t i = 0; i < n; ++i) {
+    scaled[i] = buckets_[i].weight * n / total;
+    (scaled[i] < 1.0 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t s = small.back(), l = large.back();
+    small.pop_back();
+    prob_[s] = (uint32_t)std::min(scaled[s] * 4294967296.0, 4294967295.0);
+    alias_[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // What is left is 1 up to rounding
+  for (uint32_t i : small) { prob_[i] = UINT32_MAX; alias_[i] = i; }
+  for (uint32_t i : large) { prob_[i] = UINT32_MAX; alias_[i] = i; }
+  Next();
+}
+
+inline uint64_t EmpiricalGenerator::Sample(uint64_t bits) const {
+  uint64_t column = ((bits >> 32) * buckets_.size()) >> 32;
+  uint32_t coin = (uint32_t)bits;
+  const Bucket &b = buckets_[coin < prob_[column] ? column : alias_[column]];
+  if (b.min == b.max) return b.min;
+  return b.min + utils::SplitMix64(bits) % (b.max - b.min + 1);
+}
+
+inline std::vector<EmpiricalGenerator::Bucket> EmpiricalGenerator::LoadBuckets(
+    const std::string &path) {
+  std::ifstream input(path);
+  if (!input) throw utils::Exception("Cannot open histogram file: " + path);
+  std::vector<Bucket> buckets;
+  std::string line;
+  for (int line_num = 1; std::getline(input, line); ++line_num) {
+    line = utils::Trim(line);
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string range;
+    Bucket b;
+    char extra;
+    if (!(fields >> range >> b.weight) || fields >> extra) {
+      throw utils::Exception(path + ":" + std::to_string(line_num) +
+                             ": expected \"size weight\"");
+    }
+    try {
+      size_t dash = range.find('-');
+      b.min = std::stoull(range.substr(0, dash));
+      b.max = dash == std::string::npos ?
+          b.min : std::stoull(range.substr(dash + 1));
+    } catch (const std::logic_error &) {
+      throw utils::Exception(path + ":" + std::to_string(line_num) +
+                             ": invalid size " + range);
+    }
+    buckets.push_back(b);
+  }
+  return buckets;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_EMPIRICAL_GENERATOR_H_
@@ -0,0 +1,49 @@
+//
+//  exponential_generator.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_EXPONENTIAL_GENERATOR_H_
+#define YCSB_C_EXPONENTIAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Generates exponentially distributed integers from zero, so the lowest
+/// values are the most popular. The rate is set so that percentile percent
+/// of the values fall below range; e.g. (95, 1000) keeps 95% of accesses
+/// within the first thousand items. Can be shared by all client threads.
+///
+class ExponentialGenerator : public Generator<uint64_t> {
+ public:
+  ExponentialGenerator(double percentile, double range) :
+      gamma_(-std::log(1.0 - percentile / 100.0) / range), last_(0) {
+    assert(percentile > 0 && percentile < 100);
+    assert(range > 0);
+    Next();
+  }
+
+  uint64_t Next() {
+    // 1 - u lies in (0, 1], so the logarithm is finite
+    uint64_t value = (uint64_t)(-std::log(1.0 - utils::RandomDouble()) / gamma_);
+    last_.Set(value);
+    return value;
+  }
+
+  uint64_t Last() { return last_.Get(); }
+
+ private:
+  const double gamma_;
+  ThreadLastValue last_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_EXPONENTIAL_GENERATOR_H_
@@ -9,8 +9,10 @@
 #ifndef YCSB_C_GENERATOR_H_
 #define YCSB_C_GENERATOR_H_
 
+#include <atomic>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace ycsbc {
 
@@ -22,6 +24,48 @@ class Generator {
   virtual ~Generator() { }
 };
 
+///
+/// The value a shared generator last returned, kept per calling thread so
+/// that client threads drawing from it do not write one cache line on every
+/// Next(). Threads that have not drawn yet see the initial value.
+///
+class ThreadLastValue {
+ public:
+  explicit ThreadLastValue(uint64_t initial = 0) :
+      id_(NextId()), initial_(initial) { }
+
+  void Set(uint64_t value) {
+    std::vector<Slot> &slots = Slots();
+    if (id_ >= slots.size()) slots.resize(id_ + 1);
+    slots[id_].value = value;
+    slots[id_].set = true;
+  }
+
+  uint64_t Get() const {
+    const std::vector<Slot> &slots = Slots();
+    return id_ < slots.size() && slots[id_].set ? slots[id_].value : initial_;
+  }
+
+ private:
+  struct Slot {
+    uint64_t value = 0;
+    bool set = false;
+  };
+
+  static std::size_t NextId() {
+    static std::atomic<std::size_t> next_id(0);
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static std::vector<Slot> &Slots() {
+    static thread_local std::vector<Slot> slots;
+    return slots;
+  }
+
+  const std::size_t id_;
+  const uint64_t initial_;
+};
+
 } // ycsbc
 
 #endif // YCSB_C_GENERATOR_H_
@@ -0,0 +1,197 @@
+//
+//  histogram.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_HISTOGRAM_H_
+#define YCSB_C_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+
+///
+/// Log-linear histogram in the style of HdrHistogram.
+/// Values are grouped into power-of-two buckets, and each bucket is split
+/// into linear sub-buckets, so a reported percentile is within about
+/// 2 / kSubBuckets of the recorded value at any magnitude.
+///
+/// A histogram has exactly one writer. Counters are atomics updated with
+/// relaxed load/store pairs, so recording needs no locked instruction and
+/// other threads may still read a histogram while it is being written.
+///
+class Histogram {
+ public:
+  static const int kSubBucketBits = 6;
+  static const uint64_t kSubBuckets = 1 << kSubBucketBits;
+  static const int kMaxValueBits = 42; ///< ~73 minutes in nanoseconds
+  static const std::size_t kNumCounters =
+      (kMaxValueBits - kSubBucketBits + 2) * (kSubBuckets / 2);
+
+  Histogram() { Reset(); }
+
+  Histogram(const Histogram &) = delete;
+  Histogram &operator=(const Histogram &) = delete;
+
+  ///
+  /// Records one value. Must only be called by the owning thread.
+  ///
+  void Record(uint64_t value);
+  ///
+  /// Adds all recorded values of another histogram to this one.
+  ///
+  void Merge(const Histogram &other);
+  ///
+  /// Removes the values of an earlier snapshot of the same series, leaving
+  /// only what was recorded since. Min and max are then only known at
+  /// bucket resolution.
+  ///
+  void Subtract(const Histogram &earlier);
+  void Reset();
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t Sum() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t Min() const;
+  uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+  double Mean() const;
+  ///
+  /// Returns the highest value equivalent to the given percentile (0-100),
+  /// capped by the maximum recorded value, or zero when empty.
+  ///
+  uint64_t ValueAtPercentile(double percentile) const;
+  ///
+  /// Calls fn(highest_value, count) for every non-empty bucket in order.
+  ///
+  template <class F>
+  void ForEachBucket(F fn) const;
+
+ private:
+  static std::size_t Index(uint64_t value);
+  static uint64_t HighestEquivalent(std::size_t index);
+
+  static void Add(std::atomic<uint64_t> &counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> counts_[kNumCounters];
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_;
+};
+
+inline std::size_t Histogram::Index(uint64_t value) {
+  if (value < kSubBuckets) return value;
+  int msb = 63 - __builtin_clzll(value);
+  int bucket = msb - kSubBucketBits + 1;
+  if (bucket > kMaxValueBits - kSubBucketBits) return kNumCounters - 1;
+  return bucket * (kSubBuckets / 2) + (value >> bucket);
+}
+
+inline uint64_t Histogram::HighestEquivalent(std::size_t index) {
+  if (index < kSubBuckets) return index;
+  int bucket = index / (kSubBuckets / 2) - 1;
+  uint64_t sub = index - bucket * (kSubBuckets / 2);
+  return ((sub + 1) << bucket) - 1;
+}
+
+inline void Histogram::Record(uint64_t value) {
+  Add(counts_[Index(value)], 1);
+  Add(count_, 1);
+  Add(sum_, value);
+  if (value < min_.load(std::memory_order_relaxed)) {
+    min_.store(value, std::memory_order_relaxed);
+  }
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+}
+
+inline void Histogram::Merge(const Histogram &other) {
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    uint64_t c = other.counts_[i].load(std::memory_order_relaxed);
+    if (c) Add(counts_[i], c);
+  }
+  Add(count_, other.Count());
+  Add(sum_, other.Sum());
+  if (other.min_.load(std::memory_order_relaxed) <
+      min_.load(std::memory_order_relaxed)) {
+    min_.store(other.min_.load(std::memory_order_relaxed),
+               std::memory_order_relaxed);
+  }
+  if (other.Max() > Max()) max_.store(other.Max(), std::memory_order_relaxed);
+}
+
+inline void Histogram::Subtract(const Histogram &earlier) {
+  uint64_t count = 0;
+  std::size_t lowest = kNumCounters, highest = 0;
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    uint64_t c = counts_[i].load(std::memory_order_relaxed);
+    uint64_t e = earlier.counts_[i].load(std::memory_order_relaxed);
+    c = c > e ? c - e : 0;
+    counts_[i].store(c, std::memory_order_relaxed);
+    if (c == 0) continue;
+    count += c;
+    if (lowest == kNumCounters) lowest = i;
+    highest = i;
+  }
+  count_.store(count, std::memory_order_relaxed);
+  sum_.store(Sum() > earlier.Sum() ? Sum() - earlier.Sum() : 0,
+             std::memory_order_relaxed);
+  min_.store(count ? HighestEquivalent(lowest) : UINT64_MAX,
+             std::memory_order_relaxed);
+  max_.store(count ? HighestEquivalent(highest) : 0,
+             std::memory_order_relaxed);
+}
+
+inline void Histogram::Reset() {
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    counts_[i].store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(UINT64_MAX, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+inline uint64_t Histogram::Min() const {
+  return Count() ? min_.load(std::memory_order_relaxed) : 0;
+}
+
+inline double Histogram::Mean() const {
+  uint64_t n = Count();
+  return n ? (double)Sum() / n : 0.0;
+}
+
+inline uint64_t Histogram::ValueAtPercentile(double percentile) const {
+  uint64_t n = Count();
+  if (n == 0) return 0;
+  uint64_t target = (uint64_t)(percentile / 100.0 * n + 0.5);
+  if (target < 1) target = 1;
+  if (target > n) target = n;
+
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    seen += counts_[i].load(std::memory_order_relaxed);
+    if (seen >= target) {
+      uint64_t value = HighestEquivalent(i);
+      return value < Max() ? value : Max();
+    }
+  }
+  return Max();
+}
+
+template <class F>
+inline void Histogram::ForEachBucket(F fn) const {
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    uint64_t c = counts_[i].load(std::memory_order_relaxed);
+    if (c) fn(HighestEquivalent(i), c);
+  }
+}
+
+} // utils
+
+#endif // YCSB_C_HISTOGRAM_H_
@@ -0,0 +1,63 @@
+//
+//  hotspot_generator.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_HOTSPOT_GENERATOR_H_
+#define YCSB_C_HOTSPOT_GENERATOR_H_
+
+#include "generator.h"
+
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Generates integers in [min, max] where a hot set, the lowest
+/// hot_set_fraction of the range, receives hot_op_fraction of the values.
+/// Within the hot set and within the rest, values are uniform. This fixes
+/// the working set precisely, e.g. 20% of the keys taking 80% of accesses.
+/// Can be shared by all client threads.
+///
+class HotspotGenerator : public Generator<uint64_t> {
+ public:
+  HotspotGenerator(uint64_t min, uint64_t max, double hot_set_fraction,
+                   double hot_op_fraction) :
+      min_(min), hot_op_fraction_(hot_op_fraction),
+      hot_items_((uint64_t)((max - min + 1) * hot_set_fraction)),
+      cold_items_(max - min + 1 - hot_items_), last_(min) {
+    assert(min <= max);
+    assert(hot_set_fraction >= 0 && hot_set_fraction <= 1);
+    assert(hot_op_fraction >= 0 && hot_op_fraction <= 1);
+    Next();
+  }
+
+  uint64_t Next();
+  uint64_t Last() { return last_.Get(); }
+
+ private:
+  const uint64_t min_;
+  const double hot_op_fraction_;
+  const uint64_t hot_items_;
+  const uint64_t cold_items_;
+  ThreadLastValue last_;
+};
+
+inline uint64_t HotspotGenerator::Next() {
+  utils::Xoshiro256 &random = utils::ThreadLocalRandom();
+  bool hot = cold_items_ == 0 ||
+      (hot_items_ > 0 && utils::RandomDouble() < hot_op_fraction_);
+  uint64_t value = hot ?
+      min_ + std::uniform_int_distribution<uint64_t>(0, hot_items_ - 1)(random) :
+      min_ + hot_items_ +
+          std::uniform_int_distribution<uint64_t>(0, cold_items_ - 1)(random);
+  last_.Set(value);
+  return value;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_HOTSPOT_GENERATOR_H_
@@ -0,0 +1,182 @@
+//
+//  log.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_LOG_H_
+#define YCSB_C_LOG_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#define YCSB_LOG_LEVEL_TRACE 0
+#define YCSB_LOG_LEVEL_DEBUG 1
+#define YCSB_LOG_LEVEL_INFO  2
+#define YCSB_LOG_LEVEL_WARN  3
+#define YCSB_LOG_LEVEL_ERROR 4
+#define YCSB_LOG_LEVEL_OFF   5
+
+///
+/// Messages below YCSB_LOG_LEVEL are compiled out: their arguments are still
+/// type-checked but never evaluated, so they cost nothing at run time.
+/// Override with e.g. -DYCSB_LOG_LEVEL=YCSB_LOG_LEVEL_DEBUG.
+///
+#ifndef YCSB_LOG_LEVEL
+#define YCSB_LOG_LEVEL YCSB_LOG_LEVEL_WARN
+#endif
+
+///
+/// Whether messages of level are compiled in. Guards work done only to be
+/// logged, such as dumping a structure, which the macros below cannot skip.
+///
+#define YCSB_LOG_ENABLED(level) ((level) >= YCSB_LOG_LEVEL)
+
+#define YCSB_LOG(level, ...) \
+  do { \
+    if (YCSB_LOG_ENABLED(level)) { \
+      ::utils::LogSink::Instance().Write((level), __FILE__, __LINE__, \
+                                         __VA_ARGS__); \
+    } \
+  } while (0)
+
+#define YCSB_LOG_TRACE(...) YCSB_LOG(YCSB_LOG_LEVEL_TRACE, __VA_ARGS__)
+#define YCSB_LOG_DEBUG(...) YCSB_LOG(YCSB_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define YCSB_LOG_INFO(...)  YCSB_LOG(YCSB_LOG_LEVEL_INFO, __VA_ARGS__)
+#define YCSB_LOG_WARN(...)  YCSB_LOG(YCSB_LOG_LEVEL_WARN, __VA_ARGS__)
+#define YCSB_LOG_ERROR(...) YCSB_LOG(YCSB_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+namespace utils {
+
+///
+/// Process-wide sink for the messages that are compiled in.
+/// Writers format into a slot of a bounded lock-free ring and return; a
+/// background thread copies finished lines to stderr. When the ring is full
+/// the message is dropped and counted rather than blocking the caller.
+/// Remaining lines are flushed when the process exits.
+///
+class LogSink {
+ public:
+  static const size_t kNumSlots = 4096; ///< Must be a power of two
+  static const size_t kLineSize = 256;  ///< Longer lines are truncated
+
+  static LogSink &Instance() {
+    static LogSink sink;
+    return sink;
+  }
+
+  void Write(int level, const char *file, int line, const char *format, ...)
+      __attribute__((format(printf, 5, 6)));
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  LogSink(const LogSink &) = delete;
+  LogSink &operator=(const LogSink &) = delete;
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> seq;
+    char text[kLineSize];
+  };
+
+  LogSink();
+  ~LogSink();
+
+  void Run();
+  bool Drain();
+
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> head_; ///< Next slot to claim, shared by writers
+  uint64_t tail_;              ///< Next slot to print, owned by thread_
+  std::atomic<uint64_t> dropped_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+inline LogSink::LogSink() :
+    slots_(new Slot[kNumSlots]), head_(0), tail_(0), dropped_(0),
+    stop_(false) {
+  static_assert((kNumSlots & (kNumSlots - 1)) == 0,
+                "kNumSlots must be a power of two");
+  for (size_t i = 0; i < kNumSlots; ++i) {
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+  }
+  thread_ = std::thread(&LogSink::Run, this);
+}
+
+inline LogSink::~LogSink() {
+  stop_.store(true, std::memory_order_release);
+  thread_.join();
+  Drain();
+  if (dropped()) {
+    fprintf(stderr, "[log] %llu messages dropped\n",
+            (unsigned long long)dropped());
+  }
+}
+
+inline void LogSink::Write(int level, const char *file, int line,
+                           const char *format, ...) {
+  // Claim a slot; each is free again once the printer has moved past it.
+  uint64_t pos = head_.load(std::memory_order_relaxed);
+  Slot *slot;
+  for (;;) {
+    slot = &slots_[pos & (kNumSlots - 1)];
+    int64_t diff = (int64_t)(slot->seq.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  static const char *const kNames[] = {
+    "TRACE", "DEBUG", "INFO", "WARN", "ERROR"
+  };
+  const char *base = strrchr(file, '/');
+  int n = snprintf(slot->text, kLineSize, "[%s %s:%d] ",
+                   kNames[level < 0 ? 0 : level > 4 ? 4 : level],
+                   base ? base + 1 : file, line);
+  if (n < 0 || (size_t)n >= kLineSize - 1) n = 0;
+  va_list args;
+  va_start(args, format);
+  int m = vsnprintf(slot->text + n, kLineSize - 1 - n, format, args);
+  va_end(args);
+  size_t len = n + (m < 0 ? 0 : std::min<size_t>(m, kLineSize - 2 - n));
+  slot->text[len] = '\n';
+  slot->text[len + 1] = '\0';
+  slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+inline bool LogSink::Drain() {
+  bool printed = false;
+  for (;;) {
+    Slot &slot = slots_[tail_ & (kNumSlots - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+    fputs(slot.text, stderr);
+    slot.seq.store(tail_ + kNumSlots, std::memory_order_release);
+    ++tail_;
+    printed = true;
+  }
+  if (printed) fflush(stderr);
+  return printed;
+}
+
+inline void LogSink::Run() {
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (!Drain()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+} // utils
+
+#endif // YCSB_C_LOG_H_
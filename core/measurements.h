@@ -0,0 +1,147 @@
+//
+//  measurements.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_MEASUREMENTS_H_
+#define YCSB_C_MEASUREMENTS_H_
+
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "db.h"
+#include "core_workload.h"
+#include "histogram.h"
+
+namespace ycsbc {
+
+const int kNumStatuses = DB::kError + 1;
+
+inline const char *StatusName(int status) {
+  static const char *names[kNumStatuses] = {
+    "OK", "NO_DATA", "CONFLICT", "NOT_FOUND", "ERROR"
+  };
+  return names[status];
+}
+
+///
+/// Latency histograms of one client thread, one per operation type and
+/// return status. Only the owning thread records into it.
+///
+class OpMeasurements {
+ public:
+  void Report(Operation op, int status, uint64_t latency_ns) {
+    if (status < 0 || status >= kNumStatuses) status = DB::kError;
+    histograms_[op][status].Record(latency_ns);
+  }
+
+  const utils::Histogram &histogram(Operation op, int status) const {
+    return histograms_[op][status];
+  }
+
+ private:
+  utils::Histogram histograms_[NUM_OPERATIONS][kNumStatuses];
+};
+
+///
+/// Collects the per-thread measurements of one run phase and merges them
+/// for reporting once the client threads are done.
+///
+class Measurements {
+ public:
+  ///
+  /// Allocates the measurements of a new client thread.
+  /// The returned object is owned by this Measurements instance.
+  ///
+  OpMeasurements *NewThread();
+  ///
+  /// Merges all threads' histograms for the given operation and status.
+  ///
+  void Merge(Operation op, int status, utils::Histogram &total) const;
+  ///
+  /// Returns how many operations all threads reported, whatever their
+  /// type and status.
+  ///
+  uint64_t Count() const;
+  ///
+  /// Prints count, mean and tail latencies in microseconds per operation
+  /// type, followed by a break-down per return status.
+  ///
+  void Print(std::ostream &os) const;
+
+ private:
+  static void PrintRow(std::ostream &os, Operation op, const char *status,
+                       const utils::Histogram &h);
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<OpMeasurements>> threads_;
+};
+
+inline OpMeasurements *Measurements::NewThread() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  threads_.emplace_back(new OpMeasurements);
+  return threads_.back().get();
+}
+
+inline void Measurements::Merge(Operation op, int status,
+                                utils::Histogram &total) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &t : threads_) {
+    total.Merge(t->histogram(op, status));
+  }
+}
+
+inline uint64_t Measurements::Count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t count = 0;
+  for (auto &t : threads_) {
+    for (int op = 0; op < NUM_OPERATIONS; ++op) {
+      for (int s = 0; s < kNumStatuses; ++s) {
+        count += t->histogram(Operation(op), s).Count();
+      }
+    }
+  }
+  return count;
+}
+
+inline void Measurements::PrintRow(std::ostream &os, Operation op,
+    const char *status, const utils::Histogram &h) {
+  os << OperationName(op) << '\t' << status << '\t' << h.Count() << '\t'
+     << h.Mean() / 1e3 << '\t'
+     << h.ValueAtPercentile(50) / 1e3 << '\t'
+     << h.ValueAtPercentile(90) / 1e3 << '\t'
+     << h.ValueAtPercentile(99) / 1e3 << '\t'
+     << h.ValueAtPercentile(99.9) / 1e3 << '\t'
+     << h.Max() / 1e3 << '\n';
+}
+
+inline void Measurements::Print(std::ostream &os) const {
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "# op\tstatus\tcount\tavg(us)\tp50\tp90\tp99\tp99.9\tmax\n";
+  for (int op = 0; op < NUM_OPERATIONS; ++op) {
+    utils::Histogram all;
+    std::unique_ptr<utils::Histogram> by_status[kNumStatuses];
+    for (int s = 0; s < kNumStatuses; ++s) {
+      by_status[s].reset(new utils::Histogram);
+      Merge(Operation(op), s, *by_status[s]);
+      all.Merge(*by_status[s]);
+    }
+    if (all.Count() == 0) continue;
+    PrintRow(os, Operation(op), "ALL", all);
+    for (int s = 0; s < kNumStatuses; ++s) {
+      if (by_status[s]->Count() == 0) continue;
+      PrintRow(os, Operation(op), StatusName(s), *by_status[s]);
+    }
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+} // ycsbc
+
+#endif // YCSB_C_MEASUREMENTS_H_
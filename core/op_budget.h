@@ -0,0 +1,56 @@
+//
+//  op_budget.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_OP_BUDGET_H_
+#define YCSB_C_OP_BUDGET_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace ycsbc {
+
+///
+/// Number of operations a phase may still issue, shared by its threads.
+/// Threads claim a chunk at a time, so a thread that runs faster than the
+/// others simply claims more chunks instead of idling at the end, while the
+/// shared counter is touched only once per chunk.
+///
+class OpBudget {
+ public:
+  OpBudget(uint64_t total, uint64_t chunk) :
+      total_(total), chunk_(chunk), claimed_(0) {
+    assert(chunk > 0);
+  }
+
+  ///
+  /// Claims the next chunk and returns its number of operations,
+  /// or 0 once the budget is used up.
+  ///
+  uint64_t Claim() {
+    if (claimed_.load(std::memory_order_relaxed) >= total_) return 0;
+    uint64_t first = claimed_.fetch_add(chunk_, std::memory_order_relaxed);
+    return first >= total_ ? 0 : std::min(chunk_, total_ - first);
+  }
+
+  ///
+  /// Chunk size that gives each of num_threads threads about a hundred
+  /// chunks, within [1, 1000].
+  ///
+  static uint64_t ChunkFor(uint64_t total, int num_threads) {
+    return std::max<uint64_t>(1,
+        std::min<uint64_t>(1000, total / (num_threads * 100ULL)));
+  }
+
+ private:
+  const uint64_t total_;
+  const uint64_t chunk_;
+  std::atomic<uint64_t> claimed_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_OP_BUDGET_H_
@@ -0,0 +1,126 @@
+//
+//  op_trace.cc
+//  YCSB-C
+//
+
+#include "op_trace.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "utils.h"
+
+using std::string;
+
+namespace ycsbc {
+
+void CompileTrace(CoreWorkload &wl, uint64_t num_ops, const string &path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) throw utils::Exception("Cannot create trace file: " + path);
+  if (wl.varies_key_length()) {
+    throw utils::Exception("Traces keep only zeropadding, not key_len_histogram");
+  }
+  if (wl.field_count() > UINT8_MAX + 1) {
+    throw utils::Exception("Too many fields for trace: " +
+        std::to_string(wl.field_count()));
+  }
+
+  TraceHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kTraceMagic, sizeof(header.magic));
+  header.num_ops = num_ops;
+  header.field_count = wl.field_count();
+  header.zero_padding = wl.zero_padding();
+  header.read_all_fields = wl.read_all_fields();
+  header.write_all_fields = wl.write_all_fields();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  wl.ReserveSequenceKeyNums(wl.record_count());
+
+  std::vector<TraceOp> batch;
+  batch.reserve(4096);
+  for (uint64_t i = 0; i < num_ops; ++i) {
+    TraceOp op;
+    memset(&op, 0, sizeof(op));
+    op.op = wl.NextOperation();
+    switch (op.op) {
+      case READ:
+        op.key = wl.NextTransactionKeyNum();
+        op.field = wl.NextFieldIndex();
+        break;
+      case UPDATE:
+      case READMODIFYWRITE:
+        op.key = wl.NextTransactionKeyNum();
+        op.field = wl.NextFieldIndex();
+        op.value_len = wl.NextFieldLength();
+        break;
+      case INSERT:
+        // Not acknowledged, so reads stay on the loaded records, which
+        // exist whichever thread replays this insert and when
+        op.key = wl.NextSequenceKeyNum();
+        op.value_len = wl.NextFieldLength();
+        break;
+      case SCAN: {
+        op.key = wl.NextTransactionKeyNum();
+        op.field = wl.NextFieldIndex();
+        size_t len = wl.NextScanLength();
+        if (len > UINT16_MAX) {
+          throw utils::Exception("Scan length too long for trace: " +
+              std::to_string(len));
+        }
+        op.scan_len = len;
+        break;
+      }
+      case DELETE:
+        op.key = wl.NextDeleteKeyNum();
+        break;
+      case MULTIREAD:
+        throw utils::Exception("Multi-reads cannot be compiled into a trace");
+      default:
+        throw utils::Exception("Operation request is not recognized!");
+    }
+    batch.push_back(op);
+    if (batch.size() == batch.capacity()) {
+      out.write(reinterpret_cast<const char *>(batch.data()),
+                batch.size() * sizeof(TraceOp));
+      batch.clear();
+    }
+  }
+  out.write(reinterpret_cast<const char *>(batch.data()),
+            batch.size() * sizeof(TraceOp));
+  if (!out) throw utils::Exception("Failed to write trace file: " + path);
+}
+
+TraceReader::TraceReader(const string &path) : addr_(MAP_FAILED), length_(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw utils::Exception("Cannot open trace file: " + path);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TraceHeader)) {
+    close(fd);
+    throw utils::Exception("Invalid trace file: " + path);
+  }
+  length_ = st.st_size;
+  // Fault the whole file in now rather than during the timed phase.
+  addr_ = mmap(NULL, length_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (addr_ == MAP_FAILED) throw utils::Exception("Cannot map trace: " + path);
+  madvise(addr_, length_, MADV_SEQUENTIAL);
+
+  header_ = static_cast<const TraceHeader *>(addr_);
+  ops_ = reinterpret_cast<const TraceOp *>(header_ + 1);
+  if (memcmp(header_->magic, kTraceMagic, sizeof(kTraceMagic)) != 0 ||
+      length_ != sizeof(TraceHeader) + header_->num_ops * sizeof(TraceOp)) {
+    munmap(addr_, length_);
+    throw utils::Exception("Invalid trace file: " + path);
+  }
+}
+
+TraceReader::~TraceReader() {
+  munmap(addr_, length_);
+}
+
+} // ycsbc
@@ -0,0 +1,77 @@
+//
+//  op_trace.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_OP_TRACE_H_
+#define YCSB_C_OP_TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "core_workload.h"
+
+namespace ycsbc {
+
+///
+/// A workload compiled ahead of time into a flat binary file, so that the
+/// timed phase can replay it without running any generator.
+///
+/// Layout: one TraceHeader followed by num_ops TraceOp records, both in
+/// host byte order.
+///
+struct TraceHeader {
+  char magic[8];
+  uint64_t num_ops;
+  uint32_t field_count;
+  uint32_t zero_padding;
+  uint8_t read_all_fields;
+  uint8_t write_all_fields;
+  uint8_t reserved[6];
+};
+
+struct TraceOp {
+  uint64_t key;       ///< Key number as passed to FormatKeyName()
+  uint32_t value_len; ///< Length of each written field
+  uint16_t scan_len;
+  uint8_t op;         ///< An Operation
+  uint8_t field;      ///< Field index for single-field reads and writes
+};
+
+static_assert(sizeof(TraceHeader) == 32, "Unexpected TraceHeader layout");
+static_assert(sizeof(TraceOp) == 16, "Unexpected TraceOp layout");
+
+const char kTraceMagic[8] = { 'Y', 'C', 'S', 'B', 'T', 'R', 'C', '1' };
+
+///
+/// Draws num_ops transactions from an initialized workload and writes them
+/// to path. The insert key sequence is first advanced past the records a
+/// load phase would insert, so trace inserts continue from there.
+///
+void CompileTrace(CoreWorkload &wl, uint64_t num_ops, const std::string &path);
+
+///
+/// Read-only memory mapping of a compiled trace.
+///
+class TraceReader {
+ public:
+  TraceReader(const std::string &path);
+  ~TraceReader();
+
+  TraceReader(const TraceReader &) = delete;
+  TraceReader &operator=(const TraceReader &) = delete;
+
+  const TraceHeader &header() const { return *header_; }
+  const TraceOp *ops() const { return ops_; }
+  uint64_t size() const { return header_->num_ops; }
+
+ private:
+  void *addr_;
+  std::size_t length_;
+  const TraceHeader *header_;
+  const TraceOp *ops_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_OP_TRACE_H_
@@ -0,0 +1,182 @@
+//
+//  perf_counters.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_PERF_COUNTERS_H_
+#define YCSB_C_PERF_COUNTERS_H_
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include "log.h"
+
+namespace utils {
+
+enum PerfEvent {
+  kPerfCycles,
+  kPerfInstructions,
+  kPerfCacheMisses,   ///< Generic cache misses, the last level on most CPUs
+  kPerfBranchMisses,
+  kPerfContextSwitches,
+  kNumPerfEvents
+};
+
+inline const char *PerfEventName(int event) {
+  static const char *names[kNumPerfEvents] = {
+    "cycles", "instructions", "llc-misses", "branch-misses", "ctx-switches"
+  };
+  return names[event];
+}
+
+///
+/// Counts of the events above, of one thread or summed over several.
+/// An event is left out if any of the threads could not count it.
+///
+class PerfCounts {
+ public:
+  PerfCounts() : num_threads_(0) {
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+      counts_[e] = 0;
+      valid_[e] = true;
+    }
+  }
+
+  void Add(const PerfCounts &other) {
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+      counts_[e] += other.counts_[e];
+      valid_[e] = valid_[e] && other.valid_[e];
+    }
+    num_threads_ += other.num_threads_;
+  }
+
+  uint64_t count(int event) const { return counts_[event]; }
+  bool valid(int event) const { return num_threads_ > 0 && valid_[event]; }
+  int num_threads() const { return num_threads_; }
+
+ private:
+  friend class PerfCounters;
+
+  uint64_t counts_[kNumPerfEvents];
+  bool valid_[kNumPerfEvents];
+  int num_threads_;
+};
+
+///
+/// Counts the events above for the calling thread with perf_event_open(2),
+/// from Start() to Stop(). Events the kernel or the hardware does not
+/// allow, e.g. in a VM or with a restrictive perf_event_paranoid, are not
+/// counted; kernel-mode counting falls back to user mode only. Counts are
+/// scaled up when the kernel had to multiplex the counters. Context
+/// switches, which user-mode counting would miss, come from
+/// getrusage(RUSAGE_THREAD) instead.
+///
+class PerfCounters {
+ public:
+  PerfCounters() : start_switches_(0) {
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+      fds_[e] = e == kPerfContextSwitches ? -1 : Open(PerfEvent(e));
+    }
+  }
+
+  ~PerfCounters() {
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+      if (fds_[e] >= 0) close(fds_[e]);
+    }
+  }
+
+  void Start() {
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+      if (fds_[e] < 0) continue;
+      ioctl(fds_[e], PERF_EVENT_IOC_RESET, 0);
+      ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+    start_switches_ = ContextSwitches();
+  }
+
+  ///
+  /// Stops counting and fills counts with what was counted since Start().
+  ///
+  void Stop(PerfCounts &counts) {
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+      counts.counts_[e] = 0;
+      counts.valid_[e] = false;
+      if (fds_[e] < 0) continue;
+      ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+      uint64_t value[3]; // Count, time enabled, time running
+      if (read(fds_[e], value, sizeof(value)) != sizeof(value)) continue;
+      counts.counts_[e] = value[2] == 0 ? 0 : value[2] >= value[1] ?
+          value[0] : (uint64_t)((double)value[0] * value[1] / value[2]);
+      counts.valid_[e] = true;
+    }
+    uint64_t switches = ContextSwitches();
+    if (switches != UINT64_MAX && start_switches_ != UINT64_MAX) {
+      counts.counts_[kPerfContextSwitches] = switches - start_switches_;
+      counts.valid_[kPerfContextSwitches] = true;
+    }
+    counts.num_threads_ = 1;
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+ private:
+  static int Open(PerfEvent event) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch (event) {
+      case kPerfCycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case kPerfInstructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case kPerfCacheMisses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      default:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+    int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+      attr.exclude_kernel = 1;
+      fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    static std::atomic<bool> warned[kNumPerfEvents];
+    if (fd < 0 && !warned[event].exchange(true)) {
+      YCSB_LOG_WARN("perf_event_open(%s): %s", PerfEventName(event),
+                    strerror(errno));
+    }
+    return fd;
+  }
+
+  /// Voluntary and involuntary switches so far, or UINT64_MAX if unknown
+  static uint64_t ContextSwitches() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) return UINT64_MAX;
+    return (uint64_t)usage.ru_nvcsw + (uint64_t)usage.ru_nivcsw;
+  }
+
+  int fds_[kNumPerfEvents];
+  uint64_t start_switches_;
+};
+
+} // utils
+
+#endif // YCSB_C_PERF_COUNTERS_H_
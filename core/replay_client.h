@@ -0,0 +1,135 @@
+//
+//  replay_client.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_REPLAY_CLIENT_H_
+#define YCSB_C_REPLAY_CLIENT_H_
+
+#include "client.h"
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include "op_trace.h"
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Client that issues the operations of a slice of a compiled trace in
+/// order, instead of drawing them from the workload generators.
+///
+class ReplayClient : public Client {
+ public:
+  ReplayClient(DB &db, CoreWorkload &wl, const TraceHeader &header,
+               const TraceOp *begin, const TraceOp *end,
+               OpMeasurements *measurements = NULL,
+               OpMeasurements *intended_measurements = NULL);
+
+  bool DoTransaction();
+
+ private:
+  void BuildFields(const TraceOp &op);
+  void BuildValues(const TraceOp &op, bool all_fields);
+
+  const TraceHeader &header_;
+  const TraceOp *next_;
+  const TraceOp *end_;
+  const std::string table_;
+
+  std::vector<std::string> field_names_;
+  std::string payload_; ///< Random bytes that written values are cut from
+  size_t payload_pos_;
+};
+
+inline ReplayClient::ReplayClient(DB &db, CoreWorkload &wl,
+    const TraceHeader &header, const TraceOp *begin, const TraceOp *end,
+    OpMeasurements *measurements, OpMeasurements *intended_measurements) :
+    Client(db, wl, measurements, intended_measurements), header_(header),
+    next_(begin), end_(end), table_(wl.NextTable()), payload_pos_(0) {
+  for (uint32_t i = 0; i < header.field_count; ++i) {
+    field_names_.push_back(std::string("field").append(std::to_string(i)));
+  }
+  payload_.resize(64 * 1024);
+  utils::RandomPrintChars(&payload_[0], payload_.size());
+}
+
+inline void ReplayClient::BuildFields(const TraceOp &op) {
+  fields_.resize(1);
+  fields_[0] = field_names_[op.field];
+}
+
+inline void ReplayClient::BuildValues(const TraceOp &op, bool all_fields) {
+  if (op.value_len > payload_.size()) {
+    size_t old = payload_.size();
+    payload_.resize(op.value_len);
+    utils::RandomPrintChars(&payload_[old], payload_.size() - old);
+  }
+  values_.resize(all_fields ? field_names_.size() : 1);
+  for (size_t i = 0; i < values_.size(); ++i) {
+    values_[i].first = field_names_[all_fields ? i : op.field];
+    if (payload_pos_ + op.value_len > payload_.size()) payload_pos_ = 0;
+    values_[i].second.assign(payload_, payload_pos_, op.value_len);
+    // Steps past the bytes taken, as ValuePool does, so that consecutive
+    // values do not share content
+    payload_pos_ += op.value_len + 1;
+  }
+}
+
+inline bool ReplayClient::DoTransaction() {
+  assert(next_ < end_);
+  const TraceOp &op = *next_++;
+  CoreWorkload::FormatKeyName(op.key, header_.zero_padding, key_);
+  const std::vector<std::string> *fields = NULL;
+  if (!header_.read_all_fields && op.op != INSERT && op.op != UPDATE &&
+      op.op != DELETE) {
+    BuildFields(op);
+    fields = &fields_;
+  }
+
+  result_.clear();
+  scan_result_.clear();
+  int status = -1;
+  uint64_t start = utils::NowNanos();
+  switch (op.op) {
+    case READ:
+      status = Measure(READ, start, db_.Read(table_, key_, fields, result_));
+      break;
+    case UPDATE:
+      BuildValues(op, header_.write_all_fields);
+      start = utils::NowNanos();
+      status = Measure(UPDATE, start, db_.Update(table_, key_, values_));
+      if (status == DB::kOK) workload_.KeyWritten(key_);
+      break;
+    case INSERT:
+      BuildValues(op, true);
+      start = utils::NowNanos();
+      status = Measure(INSERT, start, db_.Insert(table_, key_, values_));
+      if (status == DB::kOK) workload_.KeyWritten(key_);
+      break;
+    case SCAN:
+      status = Measure(SCAN, start,
+          db_.Scan(table_, key_, op.scan_len, fields, scan_result_));
+      break;
+    case READMODIFYWRITE:
+      BuildValues(op, header_.write_all_fields);
+      start = utils::NowNanos();
+      status = Measure(READMODIFYWRITE, start,
+          db_.ReadModifyWrite(table_, key_, fields, result_, values_));
+      break;
+    case DELETE:
+      status = Measure(DELETE, start, db_.Delete(table_, key_));
+      if (status == DB::kOK) workload_.KeyDeleted(key_);
+      break;
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+  assert(status >= 0);
+  return (status == DB::kOK ||
+          workload_.ExpectedMiss(Operation(op.op), status, key_));
+}
+
+} // ycsbc
+
+#endif // YCSB_C_REPLAY_CLIENT_H_
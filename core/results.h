@@ -0,0 +1,337 @@
+//
+//  results.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_RESULTS_H_
+#define YCSB_C_RESULTS_H_
+
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core_workload.h"
+#include "histogram.h"
+#include "measurements.h"
+#include "properties.h"
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Results of a whole run, written as one structured file at its end.
+/// Measurements are summarized as phases finish, since they do not outlive
+/// their phase. The JSON and CSV layouts are documented in README.md;
+/// bump kSchemaVersion whenever either changes incompatibly.
+///
+class RunResults {
+ public:
+  static const int kSchemaVersion = 1;
+
+  explicit RunResults(const utils::Properties &props);
+
+  ///
+  /// Records a finished phase. Properties that differ from those of the
+  /// run are kept with it, e.g. the ones set by a -phase file.
+  ///
+  void AddPhase(const std::string &name, const std::string &workload,
+                const utils::Properties &props, int num_threads,
+                int operations, double seconds,
+                const Measurements &measurements,
+                const Measurements *intended_measurements);
+
+  ///
+  /// Writes to file in the given format, "json" or "csv"; see IsFormat().
+  ///
+  void Write(const std::string &file, const std::string &format) const;
+  void WriteJson(std::ostream &os) const;
+  void WriteCsv(std::ostream &os) const;
+
+  static bool IsFormat(const std::string &format) {
+    return format == "json" || format == "csv";
+  }
+
+ private:
+  struct OpRecord {
+    Operation op;
+    int status; ///< A DB status, or -1 for all statuses together
+    uint64_t count;
+    double mean_ns;
+    uint64_t min_ns, p50_ns, p90_ns, p99_ns, p999_ns, max_ns;
+    std::vector<std::pair<uint64_t, uint64_t>> buckets;
+  };
+
+  struct PhaseRecord {
+    std::string name;
+    std::string workload;
+    std::map<std::string, std::string> properties;
+    int threads;
+    int operations;
+    double seconds;
+    std::vector<OpRecord> latency;
+    std::vector<OpRecord> intended_latency;
+  };
+
+  static OpRecord Summarize(Operation op, int status,
+                            const utils::Histogram &h);
+  static std::vector<OpRecord> Summarize(const Measurements &measurements);
+  static void WriteOps(std::ostream &os, const std::vector<OpRecord> &ops);
+  static std::string Quote(const std::string &str);
+  static std::string CsvField(const std::string &str);
+  static const char *StatusLabel(int status) {
+    return status < 0 ? "ALL" : StatusName(status);
+  }
+
+  std::map<std::string, std::string> properties_;
+  std::string hostname_, kernel_, machine_, start_time_;
+  long num_cpus_;
+  std::vector<PhaseRecord> phases_;
+};
+
+inline RunResults::RunResults(const utils::Properties &props) :
+    properties_(props.properties()),
+    num_cpus_(sysconf(_SC_NPROCESSORS_ONLN)) {
+  char host[256] = "";
+  gethostname(host, sizeof(host) - 1);
+  hostname_ = host;
+  struct utsname u;
+  if (uname(&u) == 0) {
+    kernel_ = std::string(u.sysname) + " " + u.release;
+    machine_ = u.machine;
+  }
+  char stamp[32];
+  time_t now = time(NULL);
+  struct tm tm;
+  strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime_r(&now, &tm));
+  start_time_ = stamp;
+}
+
+inline RunResults::OpRecord RunResults::Summarize(Operation op, int status,
+    const utils::Histogram &h) {
+  OpRecord r;
+  r.op = op;
+  r.status = status;
+  r.count = h.Count();
+  r.mean_ns = h.Mean();
+  r.min_ns = h.Min();
+  r.p50_ns = h.ValueAtPercentile(50);
+  r.p90_ns = h.ValueAtPercentile(90);
+  r.p99_ns = h.ValueAtPercentile(99);
+  r.p999_ns = h.ValueAtPercentile(99.9);
+  r.max_ns = h.Max();
+  h.ForEachBucket([&r](uint64_t value, uint64_t count) {
+    r.buckets.emplace_back(value, count);
+  });
+  return r;
+}
+
+inline std::vector<RunResults::OpRecord> RunResults::Summarize(
+    const Measurements &measurements) {
+  std::vector<OpRecord> records;
+  for (int op = 0; op < NUM_OPERATIONS; ++op) {
+    utils::Histogram all;
+    std::unique_ptr<utils::Histogram> by_status[kNumStatuses];
+    for (int s = 0; s < kNumStatuses; ++s) {
+      by_status[s].reset(new utils::Histogram);
+      measurements.Merge(Operation(op), s, *by_status[s]);
+      all.Merge(*by_status[s]);
+    }
+    if (all.Count() == 0) continue;
+    records.push_back(Summarize(Operation(op), -1, all));
+    for (int s = 0; s < kNumStatuses; ++s) {
+      if (by_status[s]->Count() == 0) continue;
+      records.push_back(Summarize(Operation(op), s, *by_status[s]));
+    }
+  }
+  return records;
+}
+
+inline void RunResults::AddPhase(const std::string &name,
+    const std::string &workload, const utils::Properties &props,
+    int num_threads, int operations, double seconds,
+    const Measurements &measurements,
+    const Measurements *intended_measurements) {
+  PhaseRecord phase;
+  phase.name = name;
+  phase.workload = workload;
+  for (const auto &p : props.properties()) {
+    auto it = properties_.find(p.first);
+    if (it == properties_.end() || it->second != p.second) {
+      phase.properties.insert(p);
+    }
+  }
+  phase.threads = num_threads;
+  phase.operations = operations;
+  phase.seconds = seconds;
+  phase.latency = Summarize(measurements);
+  if (intended_measurements) {
+    phase.intended_latency = Summarize(*intended_measurements);
+  }
+  phases_.push_back(std::move(phase));
+}
+
+inline std::string RunResults::Quote(const std::string &str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    switch (c) {
+      case '"': quoted += "\\\""; break;
+      case '\\': quoted += "\\\\"; break;
+      case '\n': quoted += "\\n"; break;
+      case '\t': quoted += "\\t"; break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          quoted += escaped;
+        } else {
+          quoted += c;
+        }
+    }
+  }
+  return quoted + "\"";
+}
+
+///
+/// Quotes str as RFC 4180 requires if it holds a comma, quote or line break,
+/// doubling the quotes in it.
+///
+inline std::string RunResults::CsvField(const std::string &str) {
+  if (str.find_first_of(",\"\r\n") == std::string::npos) return str;
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+inline void RunResults::WriteOps(std::ostream &os,
+                                 const std::vector<OpRecord> &ops) {
+  os << "[";
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const OpRecord &r = ops[i];
+    os << (i ? "," : "") << "\n        {\"op\": " << Quote(OperationName(r.op))
+       << ", \"status\": " << Quote(StatusLabel(r.status))
+       << ", \"count\": " << r.count << ", \"mean_ns\": " << r.mean_ns
+       << ", \"min_ns\": " << r.min_ns << ", \"p50_ns\": " << r.p50_ns
+       << ", \"p90_ns\": " << r.p90_ns << ", \"p99_ns\": " << r.p99_ns
+       << ", \"p999_ns\": " << r.p999_ns << ", \"max_ns\": " << r.max_ns
+       << ",\n         \"buckets\": [";
+    for (size_t b = 0; b < r.buckets.size(); ++b) {
+      os << (b ? ", " : "") << "[" << r.buckets[b].first << ", "
+         << r.buckets[b].second << "]";
+    }
+    os << "]}";
+  }
+  os << (ops.empty() ? "]" : "\n      ]");
+}
+
+inline void RunResults::WriteJson(std::ostream &os) const {
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "{\n  \"schema_version\": " << kSchemaVersion << ",\n";
+  os << "  \"host\": {\"hostname\": " << Quote(hostname_)
+     << ", \"kernel\": " << Quote(kernel_)
+     << ", \"machine\": " << Quote(machine_)
+     << ", \"cpus\": " << num_cpus_
+     << ", \"start_time\": " << Quote(start_time_) << "},\n";
+  os << "  \"properties\": {";
+  bool first = true;
+  for (const auto &p : properties_) {
+    os << (first ? "\n    " : ",\n    ") << Quote(p.first) << ": "
+       << Quote(p.second);
+    first = false;
+  }
+  os << "\n  },\n  \"phases\": [";
+  for (size_t i = 0; i < phases_.size(); ++i) {
+    const PhaseRecord &p = phases_[i];
+    os << (i ? "," : "") << "\n    {\n      \"name\": " << Quote(p.name)
+       << ",\n      \"workload\": " << Quote(p.workload)
+       << ",\n      \"properties\": {";
+    first = true;
+    for (const auto &q : p.properties) {
+      os << (first ? "" : ", ") << Quote(q.first) << ": " << Quote(q.second);
+      first = false;
+    }
+    uint64_t errors[kNumStatuses] = {};
+    for (const OpRecord &r : p.latency) {
+      if (r.status > 0) errors[r.status] += r.count;
+    }
+    os << "},\n      \"threads\": " << p.threads
+       << ",\n      \"operations\": " << p.operations
+       << ",\n      \"seconds\": " << std::setprecision(6) << p.seconds
+       << std::setprecision(3) << ",\n      \"throughput\": "
+       << (p.seconds > 0 ? p.operations / p.seconds : 0.0)
+       << ",\n      \"errors\": {";
+    first = true;
+    for (int s = 1; s < kNumStatuses; ++s) {
+      os << (first ? "" : ", ") << Quote(StatusName(s)) << ": " << errors[s];
+      first = false;
+    }
+    os << "},\n      \"latency\": ";
+    WriteOps(os, p.latency);
+    os << ",\n      \"intended_latency\": ";
+    WriteOps(os, p.intended_latency);
+    os << "\n    }";
+  }
+  os << "\n  ]\n}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+inline void RunResults::WriteCsv(std::ostream &os) const {
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "schema_version,hostname,start_time,dbname,phase,workload,threads,"
+        "operations,seconds,throughput,series,op,status,count,mean_ns,"
+        "min_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+  auto db = properties_.find("dbname");
+  for (const PhaseRecord &p : phases_) {
+    for (int intended = 0; intended < 2; ++intended) {
+      for (const OpRecord &r : intended ? p.intended_latency : p.latency) {
+        os << kSchemaVersion << ',' << CsvField(hostname_) << ','
+           << CsvField(start_time_) << ','
+           << CsvField(db == properties_.end() ? "" : db->second) << ','
+           << CsvField(p.name) << ',' << CsvField(p.workload) << ','
+           << p.threads << ',' << p.operations
+           << ',' << std::setprecision(6) << p.seconds << std::setprecision(3)
+           << ',' << (p.seconds > 0 ? p.operations / p.seconds : 0.0) << ','
+           << (intended ? "intended" : "latency") << ','
+           << OperationName(r.op) << ',' << StatusLabel(r.status) << ','
+           << r.count << ',' << r.mean_ns << ',' << r.min_ns << ','
+           << r.p50_ns << ',' << r.p90_ns << ',' << r.p99_ns << ','
+           << r.p999_ns << ',' << r.max_ns << '\n';
+      }
+    }
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+inline void RunResults::Write(const std::string &file,
+                              const std::string &format) const {
+  std::ofstream output(file);
+  if (!output) throw utils::Exception("Cannot write results to " + file);
+  if (format == "json") {
+    WriteJson(output);
+  } else if (format == "csv") {
+    WriteCsv(output);
+  } else {
+    throw utils::Exception("Unknown export.format " + format);
+  }
+}
+
+} // ycsbc
+
+#endif // YCSB_C_RESULTS_H_
@@ -0,0 +1,48 @@
+//
+//  sequential_generator.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_SEQUENTIAL_GENERATOR_H_
+#define YCSB_C_SEQUENTIAL_GENERATOR_H_
+
+#include "generator.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace ycsbc {
+
+///
+/// Generates min, min + 1, ..., max and then wraps around to min, so every
+/// value is visited once per pass. Threads share one position and each value
+/// goes to exactly one of them.
+///
+class SequentialGenerator : public Generator<uint64_t> {
+ public:
+  // Both min and max are inclusive
+  SequentialGenerator(uint64_t min, uint64_t max) :
+      min_(min), num_items_(max - min + 1), counter_(0), last_(min) {
+    assert(min <= max);
+  }
+
+  uint64_t Next() {
+    uint64_t value = min_ +
+        counter_.fetch_add(1, std::memory_order_relaxed) % num_items_;
+    last_.Set(value);
+    return value;
+  }
+
+  uint64_t Last() { return last_.Get(); }
+
+ private:
+  const uint64_t min_;
+  const uint64_t num_items_;
+  std::atomic<uint64_t> counter_;
+  ThreadLastValue last_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_SEQUENTIAL_GENERATOR_H_
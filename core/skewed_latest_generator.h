@@ -11,7 +11,6 @@
 
 #include "generator.h"
 
-#include <atomic>
 #include <cstdint>
 #include "counter_generator.h"
 #include "zipfian_generator.h"
@@ -20,22 +19,27 @@ namespace ycsbc {
 
 class SkewedLatestGenerator : public Generator<uint64_t> {
  public:
-  SkewedLatestGenerator(CounterGenerator &counter) :
-      basis_(counter), zipfian_(basis_.Last()) {
-    Next();
+  ///
+  /// Skews towards counter.Last(), which should be at least num_items - 1
+  /// by the first Next() after construction.
+  ///
+  SkewedLatestGenerator(CounterGenerator &counter, uint64_t num_items) :
+      basis_(counter), zipfian_(num_items) {
   }
   
   uint64_t Next();
-  uint64_t Last() { return last_; }
+  uint64_t Last() { return last_.Get(); }
  private:
   CounterGenerator &basis_;
   ZipfianGenerator zipfian_;
-  std::atomic<uint64_t> last_;
+  ThreadLastValue last_;
 };
 
 inline uint64_t SkewedLatestGenerator::Next() {
   uint64_t max = basis_.Last();
-  return last_ = max - zipfian_.Next(max);
+  uint64_t value = max - zipfian_.Next(max);
+  last_.Set(value);
+  return value;
 }
 
 } // ycsbc
@@ -0,0 +1,93 @@
+//
+//  stats.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_STATS_H_
+#define YCSB_C_STATS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace utils {
+
+///
+/// Summary of repeated measurements of the same quantity.
+///
+struct SampleStats {
+  size_t n;
+  double mean;
+  double stddev;   ///< Sample standard deviation, 0 for a single sample
+  double ci95;     ///< Half-width of the 95% confidence interval of the mean
+  std::vector<bool> outlier; ///< Per sample, whether it is an outlier
+};
+
+///
+/// Two-sided 95% quantile of Student's t distribution.
+///
+inline double StudentT95(size_t degrees_of_freedom) {
+  static const double kTable[] = {
+    0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+    2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+    2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+    2.042
+  };
+  const size_t kTableSize = sizeof(kTable) / sizeof(kTable[0]);
+  if (degrees_of_freedom < kTableSize) return kTable[degrees_of_freedom];
+  return degrees_of_freedom < 60 ? 2.000 : degrees_of_freedom < 120 ?
+      1.980 : 1.960;
+}
+
+inline double Median(std::vector<double> values) {
+  if (values.empty()) return 0;
+  size_t mid = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + mid, values.end());
+  double upper = values[mid];
+  if (values.size() % 2) return upper;
+  return (*std::max_element(values.begin(), values.begin() + mid) + upper) / 2;
+}
+
+///
+/// Computes mean, standard deviation and the t-based 95% confidence
+/// interval of samples. Outliers are flagged by their modified z-score,
+/// 0.6745 (x - median) / MAD, exceeding 3.5 (Iglewicz and Hoaglin), which
+/// unlike the standard deviation is not inflated by the outlier itself.
+/// Samples that agree closely have a tiny or zero MAD, so an outlier must
+/// also deviate from the median by more than kMinOutlierDeviation of it.
+///
+const double kMinOutlierDeviation = 0.15;
+
+inline SampleStats Summarize(const std::vector<double> &samples) {
+  SampleStats s;
+  s.n = samples.size();
+  s.mean = s.stddev = s.ci95 = 0;
+  s.outlier.assign(s.n, false);
+  if (s.n == 0) return s;
+
+  for (double x : samples) s.mean += x;
+  s.mean /= s.n;
+  if (s.n < 2) return s;
+  double squares = 0;
+  for (double x : samples) squares += (x - s.mean) * (x - s.mean);
+  s.stddev = std::sqrt(squares / (s.n - 1));
+  s.ci95 = StudentT95(s.n - 1) * s.stddev / std::sqrt((double)s.n);
+
+  if (s.n < 3) return s;
+  double median = Median(samples);
+  std::vector<double> deviations;
+  for (double x : samples) deviations.push_back(std::fabs(x - median));
+  double mad = Median(deviations);
+  double min_deviation = kMinOutlierDeviation * std::fabs(median);
+  for (size_t i = 0; i < s.n; ++i) {
+    double deviation = std::fabs(samples[i] - median);
+    s.outlier[i] = deviation > min_deviation &&
+        (mad == 0 || 0.6745 * deviation / mad > 3.5);
+  }
+  return s;
+}
+
+} // utils
+
+#endif // YCSB_C_STATS_H_
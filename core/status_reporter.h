@@ -0,0 +1,125 @@
+//
+//  status_reporter.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_STATUS_REPORTER_H_
+#define YCSB_C_STATUS_REPORTER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "core_workload.h"
+#include "histogram.h"
+#include "measurements.h"
+#include "timer.h"
+
+namespace ycsbc {
+
+///
+/// Background thread that samples the measurements of a running phase and
+/// prints one line per interval with the throughput and p99 latency seen
+/// during that interval, per operation type.
+/// Reporting starts on construction and stops on destruction; an interval
+/// of zero disables it.
+///
+class StatusReporter {
+ public:
+  StatusReporter(const Measurements &measurements, const std::string &phase,
+                 double interval_sec, std::ostream &os);
+  ~StatusReporter();
+
+ private:
+  void Run();
+  void Report(double elapsed_sec);
+
+  const Measurements &measurements_;
+  const std::string phase_;
+  const std::chrono::nanoseconds interval_;
+  std::ostream &os_;
+  uint64_t start_ns_;
+  uint64_t last_ns_;
+  std::unique_ptr<utils::Histogram> last_[NUM_OPERATIONS];
+
+  bool stop_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread thread_;
+};
+
+inline StatusReporter::StatusReporter(const Measurements &measurements,
+    const std::string &phase, double interval_sec, std::ostream &os) :
+    measurements_(measurements), phase_(phase),
+    interval_((int64_t)(interval_sec * 1e9)), os_(os),
+    start_ns_(utils::NowNanos()), last_ns_(start_ns_), stop_(false) {
+  if (interval_.count() <= 0) return;
+  for (int op = 0; op < NUM_OPERATIONS; ++op) {
+    last_[op].reset(new utils::Histogram);
+  }
+  thread_ = std::thread(&StatusReporter::Run, this);
+}
+
+inline StatusReporter::~StatusReporter() {
+  if (!thread_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  thread_.join();
+}
+
+inline void StatusReporter::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto next = std::chrono::steady_clock::now() + interval_;
+  while (!cond_.wait_until(lock, next, [this]{ return stop_; })) {
+    Report((utils::NowNanos() - start_ns_) / 1e9);
+    next += interval_;
+  }
+}
+
+inline void StatusReporter::Report(double elapsed_sec) {
+  uint64_t now_ns = utils::NowNanos();
+  double span_sec = (now_ns - last_ns_) / 1e9;
+  last_ns_ = now_ns;
+
+  uint64_t total = 0, interval_ops = 0;
+  std::ostringstream ops;
+  ops << std::fixed << std::setprecision(3);
+  for (int op = 0; op < NUM_OPERATIONS; ++op) {
+    std::unique_ptr<utils::Histogram> current(new utils::Histogram);
+    for (int s = 0; s < kNumStatuses; ++s) {
+      measurements_.Merge(Operation(op), s, *current);
+    }
+    utils::Histogram delta;
+    delta.Merge(*current);
+    delta.Subtract(*last_[op]);
+    last_[op].swap(current);
+
+    total += last_[op]->Count();
+    interval_ops += delta.Count();
+    if (last_[op]->Count() == 0) continue;
+    ops << " [" << OperationName(Operation(op)) << ": "
+        << (span_sec > 0 ? delta.Count() / span_sec : 0.0) << " ops/sec, p99="
+        << delta.ValueAtPercentile(99) / 1e3 << " us]";
+  }
+
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(3)
+       << phase_ << ' ' << elapsed_sec << " sec: " << total
+       << " operations; "
+       << (span_sec > 0 ? interval_ops / span_sec : 0.0)
+       << " current ops/sec;" << ops.str() << '\n';
+  os_ << line.str() << std::flush;
+}
+
+} // ycsbc
+
+#endif // YCSB_C_STATUS_REPORTER_H_
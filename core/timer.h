@@ -111,6 +111,27 @@ static inline void sanity_timer_200ms() {
   fprintf(stderr, "[sanity] 200ms sleep measured = %.6f s\n", t1 - t0);
 }
 
+///
+/// Monotonic timestamp in nanoseconds, cheap enough to take around
+/// every DB call.
+///
+inline uint64_t NowNanos() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+///
+/// Sleeps until the given NowNanos() timestamp; returns at once if it has
+/// already passed.
+///
+inline void SleepUntilNanos(uint64_t deadline_ns) {
+  timespec ts;
+  ts.tv_sec = deadline_ns / 1000000000ull;
+  ts.tv_nsec = deadline_ns % 1000000000ull;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) { }
+}
+
 // template <typename T>
 class Timer {
  public:
@@ -0,0 +1,285 @@
+//
+//  trace_workload.cc
+//  YCSB-C
+//
+
+#include "trace_workload.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "log.h"
+#include "timer.h"
+#include "utils.h"
+
+using std::string;
+
+namespace ycsbc {
+
+const string TraceWorkload::TRACE_FILE_PROPERTY = "tracefile";
+
+const string TraceWorkload::TRACE_TIMESTAMPS_PROPERTY = "trace.timestamps";
+const string TraceWorkload::TRACE_TIMESTAMPS_DEFAULT = "false";
+
+const string TraceWorkload::TRACE_SPEEDUP_PROPERTY = "trace.speedup";
+const string TraceWorkload::TRACE_SPEEDUP_DEFAULT = "1";
+
+namespace {
+
+std::atomic<uint64_t> next_workload_id(1);
+
+inline bool IsSeparator(char c) {
+  return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+///
+/// Returns the next token of the line in [*pos, end) and moves past it.
+///
+inline size_t NextToken(const char **pos, const char *end,
+                        const char **token) {
+  const char *p = *pos;
+  while (p < end && IsSeparator(*p)) ++p;
+  *token = p;
+  while (p < end && !IsSeparator(*p)) ++p;
+  *pos = p;
+  return p - *token;
+}
+
+inline bool TokenIs(const char *token, size_t len, const char *name) {
+  return strlen(name) == len && strncasecmp(token, name, len) == 0;
+}
+
+inline bool ParseNumber(const char *token, size_t len, uint64_t &value) {
+  if (len == 0 || len > 19) return false;
+  value = 0;
+  for (size_t i = 0; i < len; ++i) {
+    if (!isdigit((unsigned char)token[i])) return false;
+    value = value * 10 + (token[i] - '0');
+  }
+  return true;
+}
+
+} // namespace
+
+TraceWorkload::TraceWorkload() :
+    id_(next_workload_id.fetch_add(1)), data_(NULL), length_(0),
+    num_chunks_(0), num_records_(0), next_chunk_(0), timestamps_(false),
+    speedup_(1), first_timestamp_us_(0), span_us_(0), start_ns_(0) {
+}
+
+TraceWorkload::~TraceWorkload() {
+  if (data_) munmap(const_cast<char *>(data_), length_);
+}
+
+bool TraceWorkload::ParseLine(const char *pos, const char *end,
+                              Record &record, const char **next) {
+  const char *eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+  if (!eol) eol = end;
+  *next = eol < end ? eol + 1 : end;
+
+  const char *token;
+  size_t len = NextToken(&pos, eol, &token);
+  if (len == 0 || *token == '#') return false;
+  if (TokenIs(token, len, "READ") || TokenIs(token, len, "GET")) {
+    record.op = READ;
+  } else if (TokenIs(token, len, "UPDATE") || TokenIs(token, len, "SET") ||
+             TokenIs(token, len, "PUT")) {
+    record.op = UPDATE;
+  } else if (TokenIs(token, len, "INSERT")) {
+    record.op = INSERT;
+  } else if (TokenIs(token, len, "SCAN")) {
+    record.op = SCAN;
+  } else if (TokenIs(token, len, "READMODIFYWRITE") ||
+             TokenIs(token, len, "RMW")) {
+    record.op = READMODIFYWRITE;
+  } else if (TokenIs(token, len, "DELETE") || TokenIs(token, len, "DEL")) {
+    record.op = DELETE;
+  } else {
+    throw utils::Exception("Unknown trace operation: " + string(token, len));
+  }
+
+  record.key_len = NextToken(&pos, eol, &record.key);
+  if (record.key_len == 0) {
+    throw utils::Exception("Trace line without a key: " + string(token, eol));
+  }
+  record.numeric_key = ParseNumber(record.key, record.key_len,
+                                   record.key_num);
+
+  record.size = 0;
+  len = NextToken(&pos, eol, &token);
+  if (len > 0 && !ParseNumber(token, len, record.size)) {
+    throw utils::Exception("Invalid size in trace: " + string(token, len));
+  }
+  len = NextToken(&pos, eol, &token);
+  record.has_timestamp = len > 0;
+  if (len > 0 && !ParseNumber(token, len, record.timestamp_us)) {
+    throw utils::Exception("Invalid timestamp in trace: " +
+                           string(token, len));
+  }
+  return true;
+}
+
+void TraceWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+
+  path_ = p.GetProperty(TRACE_FILE_PROPERTY);
+  int fd = open(path_.c_str(), O_RDONLY);
+  if (fd < 0) throw utils::Exception("Cannot open trace file: " + path_);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    throw utils::Exception("Empty trace file: " + path_);
+  }
+  length_ = st.st_size;
+  void *addr = mmap(NULL, length_, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+                    fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) throw utils::Exception("Cannot map trace: " + path_);
+  madvise(addr, length_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char *>(addr);
+  num_chunks_ = (length_ + kChunkSize - 1) / kChunkSize;
+
+  timestamps_ = utils::StrToBool(p.GetProperty(TRACE_TIMESTAMPS_PROPERTY,
+                                               TRACE_TIMESTAMPS_DEFAULT));
+  speedup_ = std::stod(p.GetProperty(TRACE_SPEEDUP_PROPERTY,
+                                     TRACE_SPEEDUP_DEFAULT));
+  if (speedup_ <= 0) throw utils::Exception("trace.speedup must be positive");
+
+  // Validates the whole log now, so a bad line cannot end a timed phase,
+  // and finds the range of its timestamps.
+  uint64_t first_ts = UINT64_MAX, last_ts = 0;
+  const char *end = data_ + length_;
+  Record record;
+  for (const char *pos = data_; pos < end; ) {
+    if (!ParseLine(pos, end, record, &pos)) continue;
+    ++num_records_;
+    if (record.op == DELETE && !deleted_keys_) {
+      deleted_keys_.reset(new DeletedKeys);
+    }
+    if (record.has_timestamp) {
+      first_ts = std::min(first_ts, record.timestamp_us);
+      last_ts = std::max(last_ts, record.timestamp_us);
+    } else if (timestamps_) {
+      throw utils::Exception("Trace line without a timestamp: " +
+                             string(record.key, record.key_len));
+    }
+  }
+  if (num_records_ == 0) {
+    throw utils::Exception("No operations in trace file: " + path_);
+  }
+  first_timestamp_us_ = timestamps_ ? first_ts : 0;
+  span_us_ = timestamps_ ? last_ts - first_ts + 1 : 0;
+  YCSB_LOG_INFO("%s: %llu operations", path_.c_str(),
+                (unsigned long long)num_records_);
+}
+
+TraceWorkload::Cursor &TraceWorkload::ThisCursor() {
+  static thread_local Cursor cursor = { 0, NULL, NULL, 0, Record() };
+  if (cursor.owner != id_) {
+    cursor.owner = id_;
+    cursor.pos = cursor.limit = NULL;
+  }
+  return cursor;
+}
+
+void TraceWorkload::ClaimChunk(Cursor &cursor) {
+  uint64_t index = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+  size_t begin = (index % num_chunks_) * kChunkSize;
+  size_t limit = std::min(begin + kChunkSize, length_);
+  // A line belongs to the chunk its first byte is in
+  if (begin > 0) {
+    const char *eol = static_cast<const char *>(
+        memchr(data_ + begin - 1, '\n', length_ - begin + 1));
+    begin = eol ? eol + 1 - data_ : length_;
+  }
+  cursor.pos = data_ + std::min(begin, limit);
+  cursor.limit = data_ + limit;
+  cursor.pass = index / num_chunks_;
+}
+
+const TraceWorkload::Record &TraceWorkload::NextRecord() {
+  Cursor &cursor = ThisCursor();
+  for (;;) {
+    while (cursor.pos < cursor.limit) {
+      if (ParseLine(cursor.pos, data_ + length_, cursor.record, &cursor.pos)) {
+        return cursor.record;
+      }
+    }
+    ClaimChunk(cursor);
+  }
+}
+
+Operation TraceWorkload::NextOperation() {
+  const Record &record = NextRecord();
+  if (timestamps_) {
+    uint64_t start = start_ns_.load(std::memory_order_relaxed);
+    if (start == 0) {
+      uint64_t now = utils::NowNanos();
+      start = start_ns_.compare_exchange_strong(start, now) ? now : start;
+    }
+    uint64_t offset_us = ThisCursor().pass * span_us_ +
+                         (record.timestamp_us - first_timestamp_us_);
+    utils::SleepUntilNanos(start + (uint64_t)(offset_us * 1e3 / speedup_));
+  }
+  return record.op;
+}
+
+void TraceWorkload::RecordKey(string &key) {
+  const Record &record = CurrentRecord();
+  if (record.numeric_key) {
+    SequenceKeyName(record.key_num, key);
+  } else {
+    key.assign(record.key, record.key_len);
+  }
+}
+
+string TraceWorkload::NextSequenceKey() {
+  string key;
+  RecordKey(key);
+  return key;
+}
+
+string TraceWorkload::NextTransactionKey() {
+  string key;
+  RecordKey(key);
+  return key;
+}
+
+size_t TraceWorkload::NextScanLength() {
+  const Record &record = CurrentRecord();
+  return record.size ? record.size : CoreWorkload::NextScanLength();
+}
+
+size_t TraceWorkload::FieldLength(const Record &record) const {
+  return std::max<uint64_t>(1, record.size / field_count_);
+}
+
+void TraceWorkload::BuildValues(std::vector<ycsbc::DB::KVPair> &values) {
+  const Record &record = CurrentRecord();
+  if (record.size == 0) {
+    CoreWorkload::BuildValues(values);
+    return;
+  }
+  values.resize(field_count_);
+  for (int i = 0; i < field_count_; ++i) {
+    values[i].first = field_names_[i];
+    FillValue(values[i].second, FieldLength(record));
+  }
+}
+
+void TraceWorkload::BuildUpdate(std::vector<ycsbc::DB::KVPair> &update) {
+  const Record &record = CurrentRecord();
+  if (record.size == 0) {
+    CoreWorkload::BuildUpdate(update);
+    return;
+  }
+  update.resize(1);
+  update[0].first = NextFieldName();
+  FillValue(update[0].second, FieldLength(record));
+}
+
+} // ycsbc
@@ -0,0 +1,141 @@
+//
+//  trace_workload.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_TRACE_WORKLOAD_H_
+#define YCSB_C_TRACE_WORKLOAD_H_
+
+#include "core_workload.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "db.h"
+#include "properties.h"
+
+namespace ycsbc {
+
+///
+/// Workload that takes its operations from a recorded access log instead
+/// of the generators. Each line of the log is one operation:
+///
+///   op key [size [timestamp]]
+///
+/// separated by spaces, tabs or commas; blank lines and lines starting with
+/// '#' are skipped. op is READ/GET, UPDATE/SET/PUT, INSERT, SCAN,
+/// READMODIFYWRITE/RMW or DELETE/DEL, in any case. A key of only digits is a record
+/// number, named like the loaded records so that a log of record ids
+/// replays against them; any other key is used verbatim. size is the total
+/// value size in bytes, split evenly over the fields, or the length of a
+/// scan; 0 or none uses the workload's own generators. timestamp is in
+/// microseconds.
+///
+/// The log is mapped into memory. Threads claim it in chunks of whole lines,
+/// so the operations of one chunk are issued in order by one thread, and
+/// they start over at the beginning when the log runs out.
+///
+class TraceWorkload : public CoreWorkload {
+ public:
+  ///
+  /// The name of the property for the path of the access log.
+  ///
+  static const std::string TRACE_FILE_PROPERTY;
+
+  ///
+  /// The name of the property for issuing each operation at its timestamp,
+  /// relative to the first one, rather than as fast as possible.
+  ///
+  static const std::string TRACE_TIMESTAMPS_PROPERTY;
+  static const std::string TRACE_TIMESTAMPS_DEFAULT;
+
+  ///
+  /// The name of the property for how many times faster than recorded the
+  /// timestamps are replayed.
+  ///
+  static const std::string TRACE_SPEEDUP_PROPERTY;
+  static const std::string TRACE_SPEEDUP_DEFAULT;
+
+  void Init(const utils::Properties &p);
+
+  void BuildValues(std::vector<ycsbc::DB::KVPair> &values);
+  void BuildUpdate(std::vector<ycsbc::DB::KVPair> &update);
+
+  std::string NextSequenceKey();
+  std::string NextTransactionKey();
+  void NextSequenceKey(std::string &key) { RecordKey(key); }
+  void NextTransactionKey(std::string &key) { RecordKey(key); }
+  void NextDeleteKey(std::string &key) { RecordKey(key); }
+  ///
+  /// Inserts take their keys from the log, not from the insert sequence,
+  /// so they have nothing to acknowledge.
+  ///
+  uint64_t NextInsertKey(std::string &key) { RecordKey(key); return 0; }
+  void InsertDone(uint64_t key_num) { }
+  Operation NextOperation();
+  size_t NextScanLength();
+
+  uint64_t num_records() const { return num_records_; }
+
+  TraceWorkload();
+  ~TraceWorkload();
+
+ private:
+  static const size_t kChunkSize = 64 * 1024;
+
+  struct Record {
+    Operation op;
+    const char *key;
+    size_t key_len;
+    bool numeric_key;
+    uint64_t key_num;
+    uint64_t size;
+    uint64_t timestamp_us;
+    bool has_timestamp;
+  };
+
+  ///
+  /// Where the calling thread is in the log, and the record it is issuing.
+  ///
+  struct Cursor {
+    uint64_t owner;  ///< id_ of the workload this cursor is for
+    const char *pos;
+    const char *limit;
+    uint64_t pass;   ///< How many times the log has been started over
+    Record record;
+  };
+
+  ///
+  /// Parses the line at pos into record. Returns false for a line without
+  /// an operation, or throws if it is malformed; the line ends at *next.
+  ///
+  static bool ParseLine(const char *pos, const char *end, Record &record,
+                        const char **next);
+
+  Cursor &ThisCursor();
+  void ClaimChunk(Cursor &cursor);
+  const Record &NextRecord();
+  const Record &CurrentRecord() { return ThisCursor().record; }
+  void RecordKey(std::string &key);
+  size_t FieldLength(const Record &record) const;
+
+  const uint64_t id_;
+  std::string path_;
+  const char *data_;
+  size_t length_;
+  size_t num_chunks_;
+  uint64_t num_records_;
+  std::atomic<uint64_t> next_chunk_;
+
+  bool timestamps_;
+  double speedup_;
+  uint64_t first_timestamp_us_;
+  uint64_t span_us_;  ///< From the first timestamp to one past the last
+  std::atomic<uint64_t> start_ns_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_TRACE_WORKLOAD_H_
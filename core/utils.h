@@ -10,9 +10,17 @@
 #define YCSB_C_UTILS_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <exception>
+#include <mutex>
 #include <random>
+#include <string>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace utils {
 
@@ -34,17 +42,183 @@ inline uint64_t FNVHash64(uint64_t val) {
 
 inline uint64_t Hash(uint64_t val) { return FNVHash64(val); }
 
+inline uint64_t SplitMix64(uint64_t val) {
+  val += 0x9E3779B97F4A7C15;
+  val = (val ^ (val >> 30)) * 0xBF58476D1CE4E5B9;
+  val = (val ^ (val >> 27)) * 0x94D049BB133111EB;
+  return val ^ (val >> 31);
+}
+
+///
+/// xoshiro256** pseudo-random generator (Blackman and Vigna).
+/// Much cheaper than std::mt19937_64 and usable with <random> distributions.
+///
+class Xoshiro256 {
+ public:
+  typedef uint64_t result_type;
+
+  explicit Xoshiro256(uint64_t seed = 0) { Seed(seed); }
+
+  void Seed(uint64_t seed) {
+    for (int i = 0; i < 4; ++i) {
+      state_[i] = SplitMix64(seed);
+      seed += 0x9E3779B97F4A7C15;
+    }
+  }
+
+  uint64_t operator()() {
+    const uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotl(state_[3], 45);
+    return result;
+  }
+
+  ///
+  /// Advances the state by 2^128 steps, so that repeatedly jumping one
+  /// generator yields non-overlapping streams.
+  ///
+  void Jump() {
+    static const uint64_t kJump[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+        0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i) {
+      for (int b = 0; b < 64; ++b) {
+        if (kJump[i] & (uint64_t(1) << b)) {
+          for (int j = 0; j < 4; ++j) s[j] ^= state_[j];
+        }
+        (*this)();
+      }
+    }
+    for (int j = 0; j < 4; ++j) state_[j] = s[j];
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+
+ private:
+  static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  uint64_t state_[4];
+};
+
+///
+/// Hands out non-overlapping random streams, one per thread.
+/// Reseeding restarts the sequence of streams; it should be done before
+/// any client thread draws a random number.
+///
+inline Xoshiro256 NextRandomStream(bool reseed = false, uint64_t seed = 0) {
+  static std::mutex mutex;
+  static Xoshiro256 streams;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (reseed) streams.Seed(seed);
+  Xoshiro256 stream = streams;
+  streams.Jump();
+  return stream;
+}
+
+///
+/// Random engine private to the calling thread. Each thread gets its own
+/// stream, so generators shared by all clients draw numbers without locking
+/// while the values they produce keep the same distribution.
+///
+inline Xoshiro256 &ThreadLocalRandom() {
+  static thread_local Xoshiro256 generator(NextRandomStream());
+  return generator;
+}
+
+///
+/// Makes the per-thread random streams, including the caller's, derive
+/// from seed.
+///
+inline void SetRandomSeed(uint64_t seed) {
+  ThreadLocalRandom() = NextRandomStream(true, seed);
+}
+
 inline double RandomDouble(double min = 0.0, double max = 1.0) {
-  static std::default_random_engine generator;
-  static std::uniform_real_distribution<double> uniform(min, max);
-  return uniform(generator);
+  // 53 random bits give every representable double in [0, 1) a fair chance
+  double unit = (ThreadLocalRandom()() >> 11) * (1.0 / (uint64_t(1) << 53));
+  return min + (max - min) * unit;
 }
 
 ///
 /// Returns an ASCII code that can be printed to desplay
 ///
 inline char RandomPrintChar() {
-  return rand() % 94 + 33;
+  return ThreadLocalRandom()() % 94 + 33;
+}
+
+///
+/// Fills buf with len printable ASCII characters ('!' to '~'), turning each
+/// random byte into a character with a multiply and shift rather than a
+/// division, and 16 or 32 bytes per step where SSE2 or AVX2 is available.
+///
+inline void RandomPrintChars(char *buf, size_t len) {
+  Xoshiro256 &rng = ThreadLocalRandom();
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i range = _mm256_set1_epi16(94);
+  const __m256i high_bytes = _mm256_set1_epi16((short)0xFF00);
+  const __m256i base = _mm256_set1_epi8(33);
+  for (; i + 32 <= len; i += 32) {
+    __m256i r = _mm256_set_epi64x(rng(), rng(), rng(), rng());
+    // (byte * 94) >> 8 for the low and the high byte of each 16-bit lane
+    __m256i lo = _mm256_mulhi_epu16(_mm256_slli_epi16(r, 8), range);
+    __m256i hi = _mm256_mulhi_epu16(_mm256_and_si256(r, high_bytes), range);
+    __m256i c = _mm256_or_si256(lo, _mm256_slli_epi16(hi, 8));
+    _mm256_storeu_si256((__m256i *)(buf + i), _mm256_add_epi8(c, base));
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i range128 = _mm_set1_epi16(94);
+  const __m128i high_bytes128 = _mm_set1_epi16((short)0xFF00);
+  const __m128i base128 = _mm_set1_epi8(33);
+  for (; i + 16 <= len; i += 16) {
+    __m128i r = _mm_set_epi64x(rng(), rng());
+    __m128i lo = _mm_mulhi_epu16(_mm_slli_epi16(r, 8), range128);
+    __m128i hi = _mm_mulhi_epu16(_mm_and_si128(r, high_bytes128), range128);
+    __m128i c = _mm_or_si128(lo, _mm_slli_epi16(hi, 8));
+    _mm_storeu_si128((__m128i *)(buf + i), _mm_add_epi8(c, base128));
+  }
+#endif
+  while (i < len) {
+    uint64_t r = rng();
+    for (int j = 0; j < 8 && i < len; ++j, ++i, r >>= 8) {
+      buf[i] = 33 + (((r & 0xFF) * 94) >> 8);
+    }
+  }
+}
+
+const int kMaxDecimalDigits = 20; ///< Digits of UINT64_MAX
+
+///
+/// Writes the decimal digits of val backwards, ending just before end,
+/// two digits per division. Returns the position of the first digit.
+///
+inline char *FormatDecimal(uint64_t val, char *end) {
+  static const char kDigitPairs[] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  while (val >= 100) {
+    unsigned pair = (val % 100) * 2;
+    val /= 100;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  }
+  if (val < 10) {
+    *--end = '0' + val;
+  } else {
+    *--end = kDigitPairs[val * 2 + 1];
+    *--end = kDigitPairs[val * 2];
+  }
+  return end;
 }
 
 class Exception : public std::exception {
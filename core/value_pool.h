@@ -0,0 +1,49 @@
+//
+//  value_pool.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_VALUE_POOL_H_
+#define YCSB_C_VALUE_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "utils.h"
+
+namespace ycsbc {
+
+///
+/// Arena of random printable bytes generated once, from which field values
+/// are copied instead of being generated byte by byte per operation.
+/// Each thread reads from its own cursor, which starts at a random offset
+/// and advances by one byte more than it copied, so consecutive values do
+/// not repeat the same content.
+///
+class ValuePool {
+ public:
+  ///
+  /// Creates a pool of size bytes; values taken from it must be shorter.
+  ///
+  explicit ValuePool(size_t size) : pool_(size, '\0') {
+    utils::RandomPrintChars(&pool_[0], pool_.size());
+  }
+
+  void Fill(std::string &value, size_t len) const;
+
+  size_t size() const { return pool_.size(); }
+
+ private:
+  std::string pool_;
+};
+
+inline void ValuePool::Fill(std::string &value, size_t len) const {
+  static thread_local uint64_t cursor = utils::ThreadLocalRandom()();
+  size_t pos = cursor % (pool_.size() - len);
+  cursor = pos + len + 1;
+  value.assign(pool_, pos, len);
+}
+
+} // ycsbc
+
+#endif // YCSB_C_VALUE_POOL_H_
@@ -9,6 +9,7 @@
 #ifndef YCSB_C_ZIPFIAN_GENERATOR_H_
 #define YCSB_C_ZIPFIAN_GENERATOR_H_
 
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -17,6 +18,14 @@
 
 namespace ycsbc {
 
+///
+/// Zipfian generator that can be shared by all client threads.
+/// Random numbers come from thread-local streams and the precomputed
+/// zeta/eta constants are read without locking. Only growing the item
+/// count, which the "latest" distribution does as records are inserted,
+/// takes a lock, and readers then retry on a sequence counter instead of
+/// waiting.
+///
 class ZipfianGenerator : public Generator<uint64_t> {
  public:
   constexpr static const double kZipfianConst = 0.99;
@@ -25,12 +34,12 @@ class ZipfianGenerator : public Generator<uint64_t> {
   ZipfianGenerator(uint64_t min, uint64_t max,
                    double zipfian_const = kZipfianConst) :
       num_items_(max - min + 1), base_(min), theta_(zipfian_const),
-      zeta_n_(0), n_for_zeta_(0) {
+      zeta_n_(0), eta_(0), n_for_zeta_(0), version_(0), last_value_(0) {
     assert(num_items_ >= 2 && num_items_ < kMaxNumItems);
     zeta_2_ = Zeta(2, theta_);
     alpha_ = 1.0 / (1.0 - theta_);
+    half_pow_theta_ = std::pow(0.5, theta_);
     RaiseZeta(num_items_);
-    eta_ = Eta();
     
     Next();
   }
@@ -46,18 +55,30 @@ class ZipfianGenerator : public Generator<uint64_t> {
   
  private:
   ///
-  /// Compute the zeta constant needed for the distribution.
+  /// Compute the zeta constant needed for the distribution, and eta from it.
   /// Remember the number of items, so if it is changed, we can recompute zeta.
+  /// Called with mutex_ held; publishes the new constants to lock-free
+  /// readers under version_.
   ///
   void RaiseZeta(uint64_t num) {
-    assert(num >= n_for_zeta_);
-    zeta_n_ = Zeta(n_for_zeta_, num, theta_, zeta_n_);
-    n_for_zeta_ = num;
+    uint64_t n = n_for_zeta_.load(std::memory_order_relaxed);
+    assert(num >= n);
+    double zeta_n = Zeta(n, num, theta_,
+                         zeta_n_.load(std::memory_order_relaxed));
+    double eta = Eta(zeta_n);
+
+    uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    zeta_n_.store(zeta_n, std::memory_order_relaxed);
+    eta_.store(eta, std::memory_order_relaxed);
+    n_for_zeta_.store(num, std::memory_order_relaxed);
+    version_.store(version + 2, std::memory_order_release);
   }
   
-  double Eta() {
+  double Eta(double zeta_n) const {
     return (1 - std::pow(2.0 / num_items_, 1 - theta_)) /
-        (1 - zeta_2_ / zeta_n_);
+        (1 - zeta_2_ / zeta_n);
   }
 
   ///
@@ -79,42 +100,55 @@ class ZipfianGenerator : public Generator<uint64_t> {
     return Zeta(0, num, theta, 0);
   }
   
-  uint64_t num_items_;
-  uint64_t base_; /// Min number of items to generate
+  const uint64_t num_items_;
+  const uint64_t base_; /// Min number of items to generate
   
   // Computed parameters for generating the distribution
-  double theta_, zeta_n_, eta_, alpha_, zeta_2_;
-  uint64_t n_for_zeta_; /// Number of items used to compute zeta_n
-  uint64_t last_value_;
-  std::mutex mutex_;
+  const double theta_;
+  double alpha_, zeta_2_, half_pow_theta_;
+  std::atomic<double> zeta_n_, eta_;
+  std::atomic<uint64_t> n_for_zeta_; /// Number of items used to compute zeta_n
+  std::atomic<uint64_t> version_; /// Odd while zeta_n_ and eta_ are updated
+  ThreadLastValue last_value_;
+  std::mutex mutex_; /// Serializes RaiseZeta()
 };
 
 inline uint64_t ZipfianGenerator::Next(uint64_t num) {
   assert(num >= 2 && num < kMaxNumItems);
-  std::lock_guard<std::mutex> lock(mutex_);
 
-  if (num > n_for_zeta_) { // Recompute zeta_n and eta
-    RaiseZeta(num);
-    eta_ = Eta();
+  if (num > n_for_zeta_.load(std::memory_order_acquire)) {
+    // Recompute zeta_n and eta
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (num > n_for_zeta_.load(std::memory_order_relaxed)) RaiseZeta(num);
   }
+
+  double zeta_n, eta;
+  uint64_t version;
+  do {
+    version = version_.load(std::memory_order_acquire);
+    zeta_n = zeta_n_.load(std::memory_order_relaxed);
+    eta = eta_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((version & 1) ||
+           version != version_.load(std::memory_order_relaxed));
   
   double u = utils::RandomDouble();
-  double uz = u * zeta_n_;
+  double uz = u * zeta_n;
   
+  uint64_t value;
   if (uz < 1.0) {
-    return last_value_ = 0;
+    value = 0;
+  } else if (uz < 1.0 + half_pow_theta_) {
+    value = 1;
+  } else {
+    value = base_ + num * std::pow(eta * u - eta + 1, alpha_);
   }
-  
-  if (uz < 1.0 + std::pow(0.5, theta_)) {
-    return last_value_ = 1;
-  }
-
-  return last_value_ = base_ + num * std::pow(eta_ * u - eta_ + 1, alpha_);
+  last_value_.Set(value);
+  return value;
 }
 
 inline uint64_t ZipfianGenerator::Last() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return last_value_;
+  return last_value_.Get();
 }
 
 }
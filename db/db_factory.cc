@@ -20,6 +20,9 @@
 #include <string>
 #include "db/basic_db.h"
 #include "db/lock_stl_db.h"
+#include "db/striped_stl_db.h"
+#include "db/measured_db.h"
+#include "core/utils.h"
 
 #if ENABLE_TBB
 #include "db/tbb_rand_db.h"
@@ -35,11 +38,23 @@ using namespace std;
 using ycsbc::DB;
 using ycsbc::DBFactory;
 
-DB* DBFactory::CreateDB(utils::Properties &props) {
+namespace ycsbc {
+namespace {
+
+DB* NewDB(utils::Properties &props) {
+  // Hashtable DBs guard records against concurrent deletion only if asked
+  const bool record_locks =
+      utils::StrToBool(props.GetProperty("recordlocks", "false"));
   if (props["dbname"] == "basic") {
     return new BasicDB;
   } else if (props["dbname"] == "lock_stl") {
-    return new LockStlDB;
+    return new LockStlDB(record_locks);
+  } else if (props["dbname"] == "striped_stl") {
+    int num_shards = stoi(props.GetProperty("striped.shards", "64"));
+    if (num_shards < 1) {
+      throw utils::Exception("striped.shards must be positive");
+    }
+    return new StripedStlDB(record_locks, num_shards);
 #if ENABLE_REDIS
   } else if (props["dbname"] == "redis") {
     int port = stoi(props["port"]);
@@ -48,12 +63,23 @@ DB* DBFactory::CreateDB(utils::Properties &props) {
 #endif
 #if ENABLE_TBB
   } else if (props["dbname"] == "tbb_rand") {
-    return new TbbRandDB;
+    return new TbbRandDB(record_locks);
   } else if (props["dbname"] == "tbb_scan") {
-    return new TbbScanDB;
+    return new TbbScanDB(record_locks);
 #endif
   } else return NULL;
 }
 
+} // namespace
+} // ycsbc
+
+DB* DBFactory::CreateDB(utils::Properties &props) {
+  DB *db = NewDB(props);
+  if (db && utils::StrToBool(props.GetProperty("measuredb", "false"))) {
+    return new MeasuredDB(db);
+  }
+  return db;
+}
+
 // ./ycsbc -db lock_stl -threads 4 -P workloads/workloada.spec
 // ./ycsbc -db lock_stl -threads 1 -P workloads/workloada.spec
\ No newline at end of file
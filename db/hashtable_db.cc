@@ -8,6 +8,7 @@
 
 #include "db/hashtable_db.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "lib/string_hashtable.h"
@@ -20,11 +21,12 @@ namespace ycsbc {
 
 int HashtableDB::Read(const string &table, const string &key,
     const vector<string> *fields, vector<KVPair> &result) {
+  result.clear();
   string key_index(table + key);
+  ReadLock lock(LockOf(key_index));
   FieldHashtable *field_table = key_table_->Get(key_index.c_str());
   if (!field_table) return DB::kErrorNoData;
 
-  result.clear();
   if (!fields) {
     vector<FieldHashtable::KVPair> field_pairs = field_table->Entries();
     for (auto &field_pair : field_pairs) {
@@ -43,6 +45,7 @@ int HashtableDB::Read(const string &table, const string &key,
 int HashtableDB::Scan(const string &table, const string &key, int len,
     const vector<string> *fields, vector<vector<KVPair>> &result) {
   string key_index(table + key);
+  ReadAllLock lock(AllLocks());
   vector<KeyHashtable::KVPair> key_pairs =
       key_table_->Entries(key_index.c_str(), len);
 
@@ -73,6 +76,8 @@ int HashtableDB::Scan(const string &table, const string &key, int len,
 int HashtableDB::Update(const string &table, const string &key,
     vector<KVPair> &values) {
   string key_index(table + key);
+  // Frees the values it replaces, which readers may still be copying
+  WriteLock lock(LockOf(key_index));
   FieldHashtable *field_table = key_table_->Get(key_index.c_str());
   if (!field_table) {
     field_table = NewFieldHashtable();
@@ -98,6 +103,7 @@ int HashtableDB::Update(const string &table, const string &key,
 int HashtableDB::Insert(const string &table, const string &key,
     vector<KVPair> &values) {
   string key_index(table + key);
+  ReadLock lock(LockOf(key_index));
   FieldHashtable *field_table = key_table_->Get(key_index.c_str());
   if (!field_table) {
     field_table = NewFieldHashtable();
@@ -115,8 +121,44 @@ int HashtableDB::Insert(const string &table, const string &key,
   return DB::kOK;
 }
 
+int HashtableDB::BatchInsert(const string &table, const vector<string> &keys,
+    vector<vector<KVPair>> &values, size_t *num_inserted) {
+  // Build each record's field table first, so that the key table is
+  // entered only once for the whole batch. The tables are not reachable
+  // until inserted, so no record lock is needed.
+  const size_t n = keys.size();
+  vector<string> key_indexes(n);
+  vector<KeyHashtable::KVPair> records(n);
+  for (size_t i = 0; i < n; ++i) {
+    key_indexes[i] = table + keys[i];
+    FieldHashtable *field_table = NewFieldHashtable();
+    for (KVPair &field_pair : values[i]) {
+      const char *value = CopyString(field_pair.second);
+      if (!field_table->Insert(field_pair.first.c_str(), value)) {
+        DeleteString(value);
+      }
+    }
+    records[i] = std::make_pair(key_indexes[i].c_str(), field_table);
+  }
+
+  std::unique_ptr<bool[]> inserted(new bool[n]);
+  size_t count = key_table_->InsertBatch(records.data(), n, inserted.get());
+  // Records whose key already exists get the one-by-one semantics
+  int status = DB::kOK;
+  for (size_t i = 0; i < n && count < n; ++i) {
+    if (inserted[i]) continue;
+    DeleteFieldHashtable(records[i].second);
+    int s = Insert(table, keys[i], values[i]);
+    if (s != DB::kOK) status = s;
+    else ++count;
+  }
+  if (num_inserted) *num_inserted = count;
+  return status;
+}
+
 int HashtableDB::Delete(const string &table, const string &key) {
   string key_index(table + key);
+  WriteLock lock(LockOf(key_index));
   FieldHashtable *field_table = key_table_->Remove(key_index.c_str());
   if (!field_table) {
     return DB::kErrorNoData;
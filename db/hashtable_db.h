@@ -11,12 +11,22 @@
 
 #include "core/db.h"
 
+#include <pthread.h>
+#include <functional>
 #include <string>
 #include <vector>
 #include "lib/string_hashtable.h"
 
 namespace ycsbc {
 
+///
+/// DB over a key table whose values are per-record field tables.
+/// Delete() frees a record's field table and Update() the values it
+/// replaces, so when record_locks is set, those two hold the write side of
+/// the lock stripe of their key and every other call that uses a field
+/// table the read side. Runs that never delete leave it unset and take no
+/// record locks, as the tables lock themselves.
+///
 class HashtableDB : public DB {
  public:
   typedef vmp::StringHashtable<const char *> FieldHashtable;
@@ -32,10 +42,15 @@ class HashtableDB : public DB {
              std::vector<KVPair> &values);
   int Insert(const std::string &table, const std::string &key,
              std::vector<KVPair> &values);
+  int BatchInsert(const std::string &table,
+                  const std::vector<std::string> &keys,
+                  std::vector<std::vector<KVPair>> &values,
+                  size_t *num_inserted = NULL);
   int Delete(const std::string &table, const std::string &key);
 
  protected:
-  HashtableDB(KeyHashtable *table) : key_table_(table) { }
+  HashtableDB(KeyHashtable *table, bool record_locks);
+  ~HashtableDB();
 
   virtual FieldHashtable *NewFieldHashtable() = 0;
   virtual void DeleteFieldHashtable(FieldHashtable *table) = 0;
@@ -44,8 +59,81 @@ class HashtableDB : public DB {
   virtual void DeleteString(const char *str) = 0;
 
   KeyHashtable *key_table_;
+
+ private:
+  static const size_t kNumRecordLocks = 64;
+
+  struct RecordLock {
+    pthread_rwlock_t lock;
+    char padding[64]; ///< Keeps neighbouring locks off one cache line
+  };
+
+  // The lock classes below do nothing when given NULL
+
+  class ReadLock {
+   public:
+    explicit ReadLock(RecordLock *l) : l_(l) {
+      if (l_) pthread_rwlock_rdlock(&l_->lock);
+    }
+    ~ReadLock() { if (l_) pthread_rwlock_unlock(&l_->lock); }
+   private:
+    RecordLock *l_;
+  };
+
+  class WriteLock {
+   public:
+    explicit WriteLock(RecordLock *l) : l_(l) {
+      if (l_) pthread_rwlock_wrlock(&l_->lock);
+    }
+    ~WriteLock() { if (l_) pthread_rwlock_unlock(&l_->lock); }
+   private:
+    RecordLock *l_;
+  };
+
+  ///
+  /// Holds the read side of every stripe, for calls that touch many keys.
+  /// The key table frees a key string on removal, so the keys a scan
+  /// returns cannot be hashed to their stripes until deletes are held off.
+  ///
+  class ReadAllLock {
+   public:
+    explicit ReadAllLock(RecordLock *locks) : locks_(locks) {
+      for (size_t i = 0; locks_ && i < kNumRecordLocks; ++i) {
+        pthread_rwlock_rdlock(&locks_[i].lock);
+      }
+    }
+    ~ReadAllLock() {
+      for (size_t i = 0; locks_ && i < kNumRecordLocks; ++i) {
+        pthread_rwlock_unlock(&locks_[i].lock);
+      }
+    }
+   private:
+    RecordLock *locks_;
+  };
+
+  RecordLock *LockOf(const std::string &key_index) {
+    if (!record_locks_enabled_) return NULL;
+    return &record_locks_[std::hash<std::string>()(key_index) %
+                          kNumRecordLocks];
+  }
+
+  RecordLock *AllLocks() {
+    return record_locks_enabled_ ? record_locks_ : NULL;
+  }
+
+  const bool record_locks_enabled_;
+  RecordLock record_locks_[kNumRecordLocks];
 };
 
+inline HashtableDB::HashtableDB(KeyHashtable *table, bool record_locks) :
+    key_table_(table), record_locks_enabled_(record_locks) {
+  for (RecordLock &l : record_locks_) pthread_rwlock_init(&l.lock, NULL);
+}
+
+inline HashtableDB::~HashtableDB() {
+  for (RecordLock &l : record_locks_) pthread_rwlock_destroy(&l.lock);
+}
+
 } // ycsbc
 
 #endif // YCSB_C_HASHTABLE_DB_H_
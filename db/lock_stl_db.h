@@ -19,8 +19,9 @@ namespace ycsbc {
 
 class LockStlDB : public HashtableDB {
  public:
-  LockStlDB() : HashtableDB(
-      new vmp::LockStlHashtable<HashtableDB::FieldHashtable *>) { }
+  explicit LockStlDB(bool record_locks) : HashtableDB(
+      new vmp::LockStlHashtable<HashtableDB::FieldHashtable *>,
+      record_locks) { }
 
   ~LockStlDB() {
     std::vector<KeyHashtable::KVPair> key_pairs = key_table_->Entries();
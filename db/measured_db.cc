@@ -0,0 +1,130 @@
+//
+//  measured_db.cc
+//  YCSB-C
+//
+
+#include "db/measured_db.h"
+
+#include <atomic>
+#include <iomanip>
+
+using std::string;
+using std::vector;
+
+namespace ycsbc {
+
+namespace {
+
+std::atomic<uint64_t> next_generation(1);
+
+} // namespace
+
+MeasuredDB::MeasuredDB(DB *db) :
+    db_(db), generation_(next_generation.fetch_add(1)) {
+}
+
+MeasuredDB::ThreadCalls &MeasuredDB::ThisThread() {
+  static thread_local struct {
+    uint64_t generation;
+    ThreadCalls *calls;
+  } cache = { 0, NULL };
+  if (cache.generation != generation_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.emplace_back(new ThreadCalls);
+    cache.generation = generation_;
+    cache.calls = threads_.back().get();
+  }
+  return *cache.calls;
+}
+
+MeasuredDB::TimedRequest *MeasuredDB::Timed(Call call,
+                                             AsyncRequest *request) {
+  ThreadCalls &thread = ThisThread();
+  if (thread.free_requests.empty()) {
+    thread.requests.emplace_back(new TimedRequest(*this, thread));
+    thread.free_requests.push_back(thread.requests.back().get());
+  }
+  TimedRequest *timed = thread.free_requests.back();
+  thread.free_requests.pop_back();
+  timed->call = call;
+  timed->request = request;
+  timed->start_ns = utils::NowNanos();
+  return timed;
+}
+
+void MeasuredDB::TimedRequest::Complete(int status) {
+  db_.Record(call, start_ns, status);
+  // Free before passing on, as the caller may submit again from Complete()
+  AsyncRequest *caller = request;
+  const bool write_half = (call == kRmwRead && status == kOK);
+  const string *write_table = table, *write_key = key;
+  vector<KVPair> *write_values = values;
+  owner_.free_requests.push_back(this);
+  if (write_half) {
+    db_.db_->AsyncUpdate(*write_table, *write_key, *write_values,
+                         db_.Timed(kRmwWrite, caller));
+  } else {
+    caller->Complete(status);
+  }
+}
+
+void MeasuredDB::AsyncReadModifyWrite(const string &table, const string &key,
+                                      const vector<string> *fields,
+                                      vector<KVPair> &result,
+                                      vector<KVPair> &values,
+                                      AsyncRequest *request) {
+  // Submitted as its two halves, so that each is timed on its own as in
+  // ReadModifyWrite()
+  TimedRequest *timed = Timed(kRmwRead, request);
+  timed->table = &table;
+  timed->key = &key;
+  timed->values = &values;
+  db_->AsyncRead(table, key, fields, result, timed);
+}
+
+int MeasuredDB::ReadModifyWrite(const string &table, const string &key,
+                                const vector<string> *fields,
+                                vector<KVPair> &result,
+                                vector<KVPair> &values) {
+  uint64_t start = utils::NowNanos();
+  int status = Record(kRmwRead, start, db_->Read(table, key, fields, result));
+  if (status != kOK) return status;
+  start = utils::NowNanos();
+  return Record(kRmwWrite, start, db_->Update(table, key, values));
+}
+
+void MeasuredDB::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  threads_.clear();
+  generation_ = next_generation.fetch_add(1);
+}
+
+void MeasuredDB::Print(std::ostream &os) const {
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "# call\tstatus\tcount\tavg(us)\tp50\tp99\tmax\n";
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int call = 0; call < kNumCalls; ++call) {
+    utils::Histogram all;
+    std::unique_ptr<utils::Histogram> by_status[kNumStatuses];
+    for (int s = 0; s < kNumStatuses; ++s) {
+      by_status[s].reset(new utils::Histogram);
+      for (auto &t : threads_) by_status[s]->Merge(t->histograms[call][s]);
+      all.Merge(*by_status[s]);
+    }
+    if (all.Count() == 0) continue;
+    for (int s = -1; s < kNumStatuses; ++s) {
+      const utils::Histogram &h = s < 0 ? all : *by_status[s];
+      if (h.Count() == 0) continue;
+      os << CallName(call) << '\t' << (s < 0 ? "ALL" : StatusName(s)) << '\t'
+         << h.Count() << '\t' << h.Mean() / 1e3 << '\t'
+         << h.ValueAtPercentile(50) / 1e3 << '\t'
+         << h.ValueAtPercentile(99) / 1e3 << '\t' << h.Max() / 1e3 << '\n';
+    }
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+} // ycsbc
@@ -0,0 +1,212 @@
+//
+//  measured_db.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_MEASURED_DB_H_
+#define YCSB_C_MEASURED_DB_H_
+
+#include "core/db.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/histogram.h"
+#include "core/measurements.h"
+#include "core/timer.h"
+
+namespace ycsbc {
+
+///
+/// Wraps another DB and records the latency of every call it forwards, per
+/// method and per returned status, so that a run which is fast only because
+/// its operations fail shows it. The read and the write of a
+/// ReadModifyWrite() are recorded separately. Calls are timed with
+/// clock_gettime(CLOCK_MONOTONIC), which the vDSO serves without a system
+/// call. An Async call is timed from its submission until its request
+/// completes, and recorded as its synchronous form.
+///
+class MeasuredDB : public DB {
+ public:
+  enum Call {
+    kRead, kMultiRead, kScan, kUpdate, kInsert, kBatchInsert, kDelete,
+    kRmwRead, kRmwWrite, kNumCalls
+  };
+
+  static const char *CallName(int call) {
+    static const char *names[kNumCalls] = {
+      "Read", "MultiRead", "Scan", "Update", "Insert", "BatchInsert",
+      "Delete", "RMW-Read", "RMW-Write"
+    };
+    return names[call];
+  }
+
+  ///
+  /// Takes ownership of db.
+  ///
+  explicit MeasuredDB(DB *db);
+  ~MeasuredDB() { delete db_; }
+
+  void Init() { db_->Init(); }
+  void Close() { db_->Close(); }
+
+  int Read(const std::string &table, const std::string &key,
+           const std::vector<std::string> *fields,
+           std::vector<KVPair> &result) {
+    uint64_t start = utils::NowNanos();
+    return Record(kRead, start, db_->Read(table, key, fields, result));
+  }
+
+  int MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                const std::vector<std::string> *fields,
+                std::vector<std::vector<KVPair>> &results) {
+    uint64_t start = utils::NowNanos();
+    return Record(kMultiRead, start,
+                  db_->MultiRead(table, keys, fields, results));
+  }
+
+  int Scan(const std::string &table, const std::string &key, int len,
+           const std::vector<std::string> *fields,
+           std::vector<std::vector<KVPair>> &result) {
+    uint64_t start = utils::NowNanos();
+    return Record(kScan, start, db_->Scan(table, key, len, fields, result));
+  }
+
+  int Update(const std::string &table, const std::string &key,
+             std::vector<KVPair> &values) {
+    uint64_t start = utils::NowNanos();
+    return Record(kUpdate, start, db_->Update(table, key, values));
+  }
+
+  int Insert(const std::string &table, const std::string &key,
+             std::vector<KVPair> &values) {
+    uint64_t start = utils::NowNanos();
+    return Record(kInsert, start, db_->Insert(table, key, values));
+  }
+
+  int BatchInsert(const std::string &table,
+                  const std::vector<std::string> &keys,
+                  std::vector<std::vector<KVPair>> &values,
+                  size_t *num_inserted = NULL) {
+    uint64_t start = utils::NowNanos();
+    return Record(kBatchInsert, start,
+                  db_->BatchInsert(table, keys, values, num_inserted));
+  }
+
+  int Delete(const std::string &table, const std::string &key) {
+    uint64_t start = utils::NowNanos();
+    return Record(kDelete, start, db_->Delete(table, key));
+  }
+
+  int ReadModifyWrite(const std::string &table, const std::string &key,
+                      const std::vector<std::string> *fields,
+                      std::vector<KVPair> &result,
+                      std::vector<KVPair> &values);
+
+  void AsyncRead(const std::string &table, const std::string &key,
+                 const std::vector<std::string> *fields,
+                 std::vector<KVPair> &result, AsyncRequest *request) {
+    db_->AsyncRead(table, key, fields, result, Timed(kRead, request));
+  }
+  void AsyncMultiRead(const std::string &table,
+                      const std::vector<std::string> &keys,
+                      const std::vector<std::string> *fields,
+                      std::vector<std::vector<KVPair>> &results,
+                      AsyncRequest *request) {
+    db_->AsyncMultiRead(table, keys, fields, results,
+                        Timed(kMultiRead, request));
+  }
+  void AsyncScan(const std::string &table, const std::string &key,
+                 int record_count, const std::vector<std::string> *fields,
+                 std::vector<std::vector<KVPair>> &result,
+                 AsyncRequest *request) {
+    db_->AsyncScan(table, key, record_count, fields, result,
+                   Timed(kScan, request));
+  }
+  void AsyncUpdate(const std::string &table, const std::string &key,
+                   std::vector<KVPair> &values, AsyncRequest *request) {
+    db_->AsyncUpdate(table, key, values, Timed(kUpdate, request));
+  }
+  void AsyncInsert(const std::string &table, const std::string &key,
+                   std::vector<KVPair> &values, AsyncRequest *request) {
+    db_->AsyncInsert(table, key, values, Timed(kInsert, request));
+  }
+  void AsyncDelete(const std::string &table, const std::string &key,
+                   AsyncRequest *request) {
+    db_->AsyncDelete(table, key, Timed(kDelete, request));
+  }
+  void AsyncReadModifyWrite(const std::string &table, const std::string &key,
+                            const std::vector<std::string> *fields,
+                            std::vector<KVPair> &result,
+                            std::vector<KVPair> &values,
+                            AsyncRequest *request);
+  int Poll(int min_completions) { return db_->Poll(min_completions); }
+
+  ///
+  /// Prints count, mean and tail latencies in microseconds per call,
+  /// followed by a break-down per return status.
+  ///
+  void Print(std::ostream &os) const;
+  ///
+  /// Discards what was recorded so far, e.g. between phases. Must not race
+  /// with calls.
+  ///
+  void Reset();
+
+ private:
+  struct ThreadCalls;
+
+  ///
+  /// Stands in for a caller's request while the wrapped DB serves it, and
+  /// records the latency before passing the status on. The read half of an
+  /// AsyncReadModifyWrite() instead submits the write half if it succeeded.
+  ///
+  class TimedRequest : public AsyncRequest {
+   public:
+    TimedRequest(MeasuredDB &db, ThreadCalls &owner) :
+        db_(db), owner_(owner) { }
+    void Complete(int status);
+
+    Call call;
+    uint64_t start_ns;
+    AsyncRequest *request;
+    // What the write half updates, if call is kRmwRead
+    const std::string *table;
+    const std::string *key;
+    std::vector<KVPair> *values;
+
+   private:
+    MeasuredDB &db_;
+    ThreadCalls &owner_;
+  };
+
+  struct ThreadCalls {
+    utils::Histogram histograms[kNumCalls][kNumStatuses];
+    // Requests in flight complete on the thread that submitted them, so
+    // each thread recycles its own
+    std::vector<std::unique_ptr<TimedRequest>> requests;
+    std::vector<TimedRequest *> free_requests;
+  };
+
+  int Record(Call call, uint64_t start_ns, int status) {
+    uint64_t latency_ns = utils::NowNanos() - start_ns;
+    int s = (status < 0 || status >= kNumStatuses) ? kError : status;
+    ThisThread().histograms[call][s].Record(latency_ns);
+    return status;
+  }
+
+  ThreadCalls &ThisThread();
+  TimedRequest *Timed(Call call, AsyncRequest *request);
+
+  DB *db_;
+  uint64_t generation_; ///< Unique per instance and Reset()
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadCalls>> threads_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_MEASURED_DB_H_
@@ -14,6 +14,7 @@ namespace ycsbc {
 int RedisDB::Read(const string &table, const string &key,
          const vector<string> *fields,
          vector<KVPair> &result) {
+  result.clear();
   if (fields) {
     int argc = fields->size() + 2;
     const char *argv[argc];
@@ -50,6 +51,63 @@ int RedisDB::Read(const string &table, const string &key,
   return DB::kOK;
 }
 
+int RedisDB::MultiRead(const string &table, const vector<string> &keys,
+    const vector<string> *fields, vector<vector<KVPair>> &results) {
+  vector<const char *> argv;
+  vector<size_t> argvlen;
+  for (const string &key : keys) {
+    argv.clear();
+    argvlen.clear();
+    argv.push_back(fields ? "HMGET" : "HGETALL");
+    argvlen.push_back(strlen(argv.back()));
+    argv.push_back(key.c_str()); argvlen.push_back(key.length());
+    if (fields) {
+      for (const string &f : *fields) {
+        argv.push_back(f.data()); argvlen.push_back(f.size());
+      }
+    }
+    redisAppendCommandArgv(redis_.context(), argv.size(), argv.data(),
+                           argvlen.data());
+  }
+
+  results.resize(keys.size());
+  int status = DB::kOK;
+  for (size_t k = 0; k < keys.size(); ++k) {
+    vector<KVPair> &result = results[k];
+    result.clear();
+    redisReply *reply;
+    if (redisGetReply(redis_.context(), (void **)&reply) != REDIS_OK) {
+      // hiredis cannot read from a context after an I/O or protocol error,
+      // and the replies still pipelined on it must not reach the next
+      // command, so the connection is dropped and opened again
+      redisReconnect(redis_.context());
+      return DB::kError;
+    }
+    if (reply->type == REDIS_REPLY_ERROR) {
+      // Keeps collecting, so that no reply is left behind for later
+      status = DB::kError;
+      freeReplyObject(reply);
+      continue;
+    }
+    assert(reply->type == REDIS_REPLY_ARRAY);
+    if (fields) {
+      assert(fields->size() == reply->elements);
+      for (size_t i = 0; i < reply->elements; ++i) {
+        const char *value = reply->element[i]->str;
+        result.push_back(make_pair(fields->at(i), string(value ? value : "")));
+      }
+    } else {
+      for (size_t i = 0; i < reply->elements / 2; ++i) {
+        result.push_back(make_pair(
+            string(reply->element[2 * i]->str),
+            string(reply->element[2 * i + 1]->str)));
+      }
+    }
+    freeReplyObject(reply);
+  }
+  return status;
+}
+
 int RedisDB::Update(const string &table, const string &key,
            vector<KVPair> &values) {
   string cmd("HMSET");
@@ -29,6 +29,13 @@ class RedisDB : public DB {
            const std::vector<std::string> *fields,
            std::vector<KVPair> &result);
 
+  ///
+  /// Pipelines one HMGET or HGETALL per key and then collects the replies.
+  ///
+  int MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                const std::vector<std::string> *fields,
+                std::vector<std::vector<KVPair>> &results);
+
   int Scan(const std::string &table, const std::string &key,
            int len, const std::vector<std::string> *fields,
            std::vector<std::vector<KVPair>> &result) {
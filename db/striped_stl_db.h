@@ -0,0 +1,63 @@
+//
+//  striped_stl_db.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_STRIPED_STL_DB_H_
+#define YCSB_C_STRIPED_STL_DB_H_
+
+#include "db/hashtable_db.h"
+
+#include <string>
+#include <vector>
+#include "lib/lock_stl_hashtable.h"
+#include "lib/striped_stl_hashtable.h"
+
+namespace ycsbc {
+
+///
+/// HashtableDB whose key table is split into num_shards independently
+/// locked shards. Each record's own field table keeps a single lock, as in
+/// LockStlDB.
+///
+class StripedStlDB : public HashtableDB {
+ public:
+  StripedStlDB(bool record_locks, std::size_t num_shards) : HashtableDB(
+      new vmp::StripedStlHashtable<HashtableDB::FieldHashtable *>(num_shards),
+      record_locks) { }
+
+  ~StripedStlDB() {
+    std::vector<KeyHashtable::KVPair> key_pairs = key_table_->Entries();
+    for (auto &key_pair : key_pairs) {
+      DeleteFieldHashtable(key_pair.second);
+    }
+    delete key_table_;
+  }
+
+ protected:
+  HashtableDB::FieldHashtable *NewFieldHashtable() {
+    return new vmp::LockStlHashtable<const char *>;
+  }
+
+  void DeleteFieldHashtable(HashtableDB::FieldHashtable *table) {
+    std::vector<FieldHashtable::KVPair> pairs = table->Entries();
+    for (auto &pair : pairs) {
+      DeleteString(pair.second);
+    }
+    delete table;
+  }
+
+  const char *CopyString(const std::string &str) {
+    char *value = new char[str.length() + 1];
+    strcpy(value, str.c_str());
+    return value;
+  }
+
+  void DeleteString(const char *str) {
+    delete[] str;
+  }
+};
+
+} // ycsbc
+
+#endif // YCSB_C_STRIPED_STL_DB_H_
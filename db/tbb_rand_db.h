@@ -19,8 +19,9 @@ namespace ycsbc {
 
 class TbbRandDB : public HashtableDB {
  public:
-  TbbRandDB() : HashtableDB(
-      new vmp::TbbRandHashtable<HashtableDB::FieldHashtable *>) { }
+  explicit TbbRandDB(bool record_locks) : HashtableDB(
+      new vmp::TbbRandHashtable<HashtableDB::FieldHashtable *>,
+      record_locks) { }
 
   ~TbbRandDB() {
     std::vector<KeyHashtable::KVPair> key_pairs = key_table_->Entries();
@@ -19,8 +19,9 @@ namespace ycsbc {
 
 class TbbScanDB : public HashtableDB {
  public:
-  TbbScanDB() : HashtableDB(
-      new vmp::TbbScanHashtable<HashtableDB::FieldHashtable *>) { }
+  explicit TbbScanDB(bool record_locks) : HashtableDB(
+      new vmp::TbbScanHashtable<HashtableDB::FieldHashtable *>,
+      record_locks) { }
 
   ~TbbScanDB() {
     std::vector<KeyHashtable::KVPair> key_pairs = key_table_->Entries();
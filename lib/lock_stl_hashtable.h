@@ -24,6 +24,7 @@ class LockStlHashtable : public StlHashtable<V> {
   bool Insert(const char *key, V value);
   V Update(const char *key, V value);
   V Remove(const char *key);
+  std::size_t InsertBatch(const KVPair *pairs, std::size_t n, bool *inserted);
   std::vector<KVPair> Entries(const char *key = NULL, size_t n = -1) const;
   std::size_t Size() const;
 
@@ -55,6 +56,18 @@ inline V LockStlHashtable<V>::Remove(const char *key) {
   return StlHashtable<V>::Remove(key);
 }
 
+template<class V>
+inline std::size_t LockStlHashtable<V>::InsertBatch(const KVPair *pairs,
+    std::size_t n, bool *inserted) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    inserted[i] = StlHashtable<V>::Insert(pairs[i].first, pairs[i].second);
+    count += inserted[i];
+  }
+  return count;
+}
+
 template<class V>
 inline std::size_t LockStlHashtable<V>::Size() const {
   std::lock_guard<std::mutex> lock(mutex_);
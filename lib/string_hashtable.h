@@ -21,6 +21,19 @@ class StringHashtable {
   virtual bool Insert(const char *key, V value) = 0;
   virtual V Update(const char *key, V value) = 0;
   virtual V Remove(const char *key) = 0;
+  ///
+  /// Inserts n pairs, setting inserted[i] to whether pairs[i] was inserted.
+  /// Returns the number of pairs inserted.
+  ///
+  virtual std::size_t InsertBatch(const KVPair *pairs, std::size_t n,
+                                  bool *inserted) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      inserted[i] = Insert(pairs[i].first, pairs[i].second);
+      count += inserted[i];
+    }
+    return count;
+  }
   virtual std::vector<KVPair> Entries(const char *key = NULL,
                                       std::size_t n = -1) const = 0;
   virtual std::size_t Size() const = 0;
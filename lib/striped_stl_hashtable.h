@@ -0,0 +1,202 @@
+//
+//  striped_stl_hashtable.h
+//  YCSB-C
+//
+
+#ifndef YCSB_C_LIB_STRIPED_STL_HASHTABLE_H_
+#define YCSB_C_LIB_STRIPED_STL_HASHTABLE_H_
+
+#include "lib/string_hashtable.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <vector>
+#include "lib/stl_hashtable.h"
+#include "lib/string.h"
+
+namespace vmp {
+
+///
+/// StlHashtable split into num_shards shards by key hash, each behind a
+/// reader/writer lock of its own, so that threads on different shards never
+/// contend and readers of one shard run in parallel. Entries() walks the
+/// shards in turn, from the one holding key, locking one at a time.
+///
+template<class V>
+class StripedStlHashtable : public StringHashtable<V> {
+ public:
+  typedef typename StringHashtable<V>::KVPair KVPair;
+
+  explicit StripedStlHashtable(std::size_t num_shards = 64);
+  ~StripedStlHashtable();
+
+  V Get(const char *key) const; ///< Returns NULL if the key is not found
+  bool Insert(const char *key, V value);
+  V Update(const char *key, V value);
+  V Remove(const char *key);
+  std::size_t InsertBatch(const KVPair *pairs, std::size_t n, bool *inserted);
+  std::vector<KVPair> Entries(const char *key = NULL, size_t n = -1) const;
+  std::size_t Size() const;
+
+  StripedStlHashtable(const StripedStlHashtable &) = delete;
+  StripedStlHashtable &operator=(const StripedStlHashtable &) = delete;
+
+ private:
+  static const std::size_t kCacheLineSize = 64;
+
+  // Each shard starts a cache line of its own, so that the locks of
+  // neighbouring shards never share one
+  struct alignas(kCacheLineSize) Shard {
+    mutable pthread_rwlock_t lock;
+    StlHashtable<V> table;
+  };
+
+  class ReadLock {
+   public:
+    explicit ReadLock(const Shard &s) : s_(s) {
+      pthread_rwlock_rdlock(&s_.lock);
+    }
+    ~ReadLock() { pthread_rwlock_unlock(&s_.lock); }
+   private:
+    const Shard &s_;
+  };
+
+  class WriteLock {
+   public:
+    explicit WriteLock(Shard &s) : s_(s) {
+      pthread_rwlock_wrlock(&s_.lock);
+    }
+    ~WriteLock() { pthread_rwlock_unlock(&s_.lock); }
+   private:
+    Shard &s_;
+  };
+
+  std::size_t ShardIndex(const char *key) const {
+    // The tables inside the shard bucket by the low bits of the same hash,
+    // so the shard is picked by its mixed high bits instead
+    uint64_t h = String::Wrap(key).hash() * 0x9e3779b97f4a7c15ull;
+    return (h >> 32) % num_shards_;
+  }
+
+  const std::size_t num_shards_;
+  Shard *shards_;
+};
+
+template<class V>
+StripedStlHashtable<V>::StripedStlHashtable(std::size_t num_shards) :
+    num_shards_(num_shards), shards_(NULL) {
+  assert(num_shards > 0);
+  // new[] does not honor the alignment of Shard before C++17
+  void *memory = NULL;
+  if (posix_memalign(&memory, kCacheLineSize, num_shards * sizeof(Shard))) {
+    throw std::bad_alloc();
+  }
+  shards_ = static_cast<Shard *>(memory);
+  for (std::size_t i = 0; i < num_shards_; ++i) {
+    new (&shards_[i]) Shard;
+    pthread_rwlock_init(&shards_[i].lock, NULL);
+  }
+}
+
+template<class V>
+StripedStlHashtable<V>::~StripedStlHashtable() {
+  for (std::size_t i = 0; i < num_shards_; ++i) {
+    pthread_rwlock_destroy(&shards_[i].lock);
+    shards_[i].~Shard();
+  }
+  free(shards_);
+}
+
+template<class V>
+inline V StripedStlHashtable<V>::Get(const char *key) const {
+  const Shard &shard = shards_[ShardIndex(key)];
+  ReadLock lock(shard);
+  return shard.table.Get(key);
+}
+
+template<class V>
+inline bool StripedStlHashtable<V>::Insert(const char *key, V value) {
+  if (!key) return false;
+  Shard &shard = shards_[ShardIndex(key)];
+  WriteLock lock(shard);
+  return shard.table.Insert(key, value);
+}
+
+template<class V>
+inline V StripedStlHashtable<V>::Update(const char *key, V value) {
+  Shard &shard = shards_[ShardIndex(key)];
+  WriteLock lock(shard);
+  return shard.table.Update(key, value);
+}
+
+template<class V>
+inline V StripedStlHashtable<V>::Remove(const char *key) {
+  Shard &shard = shards_[ShardIndex(key)];
+  WriteLock lock(shard);
+  return shard.table.Remove(key);
+}
+
+template<class V>
+std::size_t StripedStlHashtable<V>::InsertBatch(const KVPair *pairs,
+    std::size_t n, bool *inserted) {
+  // Visits the pairs shard by shard, so that each shard is locked once
+  std::vector<std::pair<std::size_t, std::size_t>> order(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    inserted[i] = false;
+    order[i] = std::make_pair(pairs[i].first ? ShardIndex(pairs[i].first) :
+                              num_shards_, i);
+  }
+  std::sort(order.begin(), order.end());
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n && order[i].first < num_shards_;) {
+    Shard &shard = shards_[order[i].first];
+    WriteLock lock(shard);
+    std::size_t end = i;
+    for (; end < n && order[end].first == order[i].first; ++end) {
+      const std::size_t j = order[end].second;
+      inserted[j] = shard.table.Insert(pairs[j].first, pairs[j].second);
+      count += inserted[j];
+    }
+    i = end;
+  }
+  return count;
+}
+
+template<class V>
+std::vector<typename StripedStlHashtable<V>::KVPair>
+StripedStlHashtable<V>::Entries(const char *key, size_t n) const {
+  std::vector<KVPair> pairs;
+  std::size_t first = 0;
+  if (key) {
+    first = ShardIndex(key);
+    const Shard &shard = shards_[first];
+    ReadLock lock(shard);
+    pairs = shard.table.Entries(key, n);
+    if (pairs.empty()) return pairs;
+    ++first;
+  }
+  for (std::size_t i = first; i < num_shards_ && pairs.size() < n; ++i) {
+    const Shard &shard = shards_[i];
+    ReadLock lock(shard);
+    std::vector<KVPair> more = shard.table.Entries(NULL, n - pairs.size());
+    pairs.insert(pairs.end(), more.begin(), more.end());
+  }
+  return pairs;
+}
+
+template<class V>
+std::size_t StripedStlHashtable<V>::Size() const {
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < num_shards_; ++i) {
+    ReadLock lock(shards_[i]);
+    size += shards_[i].table.Size();
+  }
+  return size;
+}
+
+} // vmp
+
+#endif // YCSB_C_LIB_STRIPED_STL_HASHTABLE_H_
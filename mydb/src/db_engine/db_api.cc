@@ -6,6 +6,7 @@
 #include "options.hh"
 #include "compaction.hh"
 #include "range_query.hh"
+#include "log.h"
 API::API(){
     tree_ = std::make_shared<Tree>();
     lsmTree_ = std::make_unique<LSMTree>(tree_);
@@ -35,7 +36,7 @@ API::API(){
 }
 
 Status API::open() {
-    pr_info("Opening database...");
+    YCSB_LOG_INFO("Opening database...");
 
     void* buffer = aligned_alloc(4096, IMS_PAGE_SIZE);
     if (!buffer) {
@@ -58,7 +59,7 @@ Status API::open() {
         return Status::Corruption("DB_INIT decode failed");
     }      
     
-    pr_debug("open DB info");
+    YCSB_LOG_DEBUG("open DB info");
     // info.dump();
 
     getLogManager()->setNextLBN(info.next_lbn);
@@ -82,7 +83,7 @@ Status API::open() {
 
 Status API::close(){
     sstableManager_->waitAllTasksDone();
-    pr_info("Closing database  .......");
+    YCSB_LOG_INFO("Closing database  .......");
 
     // 等待過去已經排入的 flush/compaction 都完成
     
@@ -254,7 +255,7 @@ Status API::get(std::string key,std::string& value){
                 uint32_t lpn = it->value_ptr.lpn;
                 uint32_t offset = it->value_ptr.offset;
                 if(it->info.type == static_cast<uint8_t>(ValueType::kTypeDeletion) ){
-                    std::cout << "Key is not found ,becasue this key has been deleted" << std::endl;
+                    YCSB_LOG_DEBUG("Key is not found, because this key has been deleted");
                     free(buffer);
                     return Status::NotFound("The key has been deleted");
                 }
@@ -264,7 +265,7 @@ Status API::get(std::string key,std::string& value){
                     result = (*record).value;
                 }
                 else{
-                    pr_debug("Failed to read log for key: %s at LPN: %u, offset: %u", key.c_str(), lpn, offset);
+                    YCSB_LOG_ERROR("Failed to read log for key: %s at LPN: %u, offset: %u", key.c_str(), lpn, offset);
                     free(buffer);
                     return Status::IOError("Failed to read log for key");
                 }
@@ -311,7 +312,7 @@ Status API::get(std::string key,Record& rec){
                 uint32_t lpn = it->value_ptr.lpn;
                 uint32_t offset = it->value_ptr.offset;
                 if(it->info.type == static_cast<uint8_t>(ValueType::kTypeDeletion) ){
-                    std::cout << "Key is not found ,becasue this key has been deleted" << std::endl;
+                    YCSB_LOG_DEBUG("Key is not found, because this key has been deleted");
                     free(buffer);
                     return Status::NotFound("The key has been deleted");
                 }
@@ -321,7 +322,7 @@ Status API::get(std::string key,Record& rec){
                     result = record;
                 }
                 else{
-                    pr_debug("Failed to read log for key: %s at LPN: %u, offset: %u", key.c_str(), lpn, offset);
+                    YCSB_LOG_ERROR("Failed to read log for key: %s at LPN: %u, offset: %u", key.c_str(), lpn, offset);
                     free(buffer);
                     return Status::IOError("Failed to read log for key");
                 }
@@ -517,7 +518,7 @@ Status API::search(std::string key ,std::string& value){
     if(key.empty()){
         return Status::IOError("Key string is empty");
     }
-    std::cout << "Search key: " << key << std::endl;
+    YCSB_LOG_DEBUG("Search key: %s", key.c_str());
     Key userKey(key);
     InternalKey internalKey(key);
     if (memtable_) {
@@ -537,7 +538,7 @@ Status API::search(std::string key ,std::string& value){
 
     auto sstables = lsmTree_->search_key(userKey);
     if (sstables.empty()){
-        pr_info("No candidate SSTables found for key: %s", key.c_str());
+        YCSB_LOG_DEBUG("No candidate SSTables found for key: %s", key.c_str());
         return Status::OK();
     }
     SearchPackageD search_package;
@@ -545,8 +546,10 @@ Status API::search(std::string key ,std::string& value){
 
     while( !sstables.empty() ){
         auto sstable = sstables.front();
-        std::cout   << "Find SStable: " << sstable->filename << "  Key range [ " << sstable->rangeMin.toString() << " ~ "
-                    << sstable->rangeMax.toString() << " ]" <<std::endl;
+        YCSB_LOG_DEBUG("Find SStable: %s  Key range [ %s ~ %s ]",
+                       sstable->filename.c_str(),
+                       sstable->rangeMin.toString().c_str(),
+                       sstable->rangeMax.toString().c_str());
         sstables.pop();
         SearchPatternD pattern_info;
         switch (packing_){
@@ -587,7 +590,7 @@ Status API::search(std::string key ,std::string& value){
     if (encoded_package.empty()) {
         return Status::IOError("Encoded search package is empty");
     }
-    search_package.dump();
+    if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_TRACE)) search_package.dump();
     char* buffer  = (char*)allocateAligned(encoded_package.size());
     memcpy(buffer, encoded_package.data(), encoded_package.size());
 
@@ -603,7 +606,7 @@ Status API::search(std::string key ,std::string& value){
     if(key.empty()){
         return Status::IOError("Key string is empty");
     }
-    std::cout << "Search key: " << key << std::endl;
+    YCSB_LOG_DEBUG("Search key: %s", key.c_str());
     Key userKey(key);
     InternalKey internalKey(key);
     if (memtable_) {
@@ -623,7 +626,7 @@ Status API::search(std::string key ,std::string& value){
 
     auto sstables = lsmTree_->search_key(userKey);
     if (sstables.empty()){
-        pr_info("No candidate SSTables found for key: %s", key.c_str());
+        YCSB_LOG_DEBUG("No candidate SSTables found for key: %s", key.c_str());
         return Status::OK();
     }
     SearchPackageH search_package;
@@ -631,8 +634,10 @@ Status API::search(std::string key ,std::string& value){
 
     while( !sstables.empty() ){
         auto sstable = sstables.front();
-        std::cout   << "Find SStable: " << sstable->filename << "  Key range [ " << sstable->rangeMin.toString() << " ~ "
-                    << sstable->rangeMax.toString() << " ]" <<std::endl;
+        YCSB_LOG_DEBUG("Find SStable: %s  Key range [ %s ~ %s ]",
+                       sstable->filename.c_str(),
+                       sstable->rangeMin.toString().c_str(),
+                       sstable->rangeMax.toString().c_str());
         sstables.pop();
         SearchPatternH pattern_info;
         switch (packing_){
@@ -735,12 +740,14 @@ Status API::range_query(std::string start_key,
         std::string val;
         Status sv = it.ReadValue(val);
         if (!sv.ok()) {
-            std::cout << sv.ToString() << std::endl;
+            YCSB_LOG_DEBUG("Range query value read failed: %s",
+                           sv.ToString().c_str());
             return sv;
         }
         InternalKey ik = InternalKey::Decode(std::string(it.key()));
 
-        std::cout << "KEY: " << ik.UserKey() << "[seq: " << ik.info.seq << "] " << " -> VAL: " << val << "\n";
+        YCSB_LOG_TRACE("KEY: %s[seq: %llu]  -> VAL: %s", ik.UserKey().c_str(),
+                       (unsigned long long)ik.info.seq, val.c_str());
     }
 
     return Status::OK();
@@ -768,15 +775,19 @@ void API::compaction() {
     bool compaction = false;
     // ---------- L0 -> L1 ----------
     if (getLSMTree()->get_level_num(0) >= LEVEL0_MAX) {
-        pr_debug("Compaction start tree info:");
-        lsmTree_->dump_lsmtere();
+        if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)) {
+            YCSB_LOG_DEBUG("Compaction start tree info:");
+            lsmTree_->dump_lsmtere();
+        }
         compaction = true;
-        pr_debug("Compaction triggered at Level 0");
+        YCSB_LOG_DEBUG("Compaction triggered at Level 0");
         auto node = getLSMTree()->findLevel0Older();
         if (!node) return;
 
-        pr_debug("Dump compaction source info:");
-        node->dump();
+        if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)) {
+            YCSB_LOG_DEBUG("Dump compaction source info:");
+            node->dump();
+        }
 
         // 來源/目的候選：vector
         auto srcNodes = getLSMTree()->search_one_level(0, node->rangeMin, node->rangeMax);
@@ -800,18 +811,18 @@ void API::compaction() {
 
         auto dstNodes = getLSMTree()->search_one_level(1, srcMin, srcMax);
 
-        pr_debug("Dump source nodes info:");
-        for(auto srcNode : srcNodes){
-            
-            srcNode->dump();   
-        }
-        pr_debug("Dump source nodes end");
-        pr_debug("Dump destination nodes info:");
-        for(auto dstNode : dstNodes){
-            
-            dstNode->dump();   
+        if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)) {
+            YCSB_LOG_DEBUG("Dump source nodes info:");
+            for(auto srcNode : srcNodes){
+                srcNode->dump();
+            }
+            YCSB_LOG_DEBUG("Dump source nodes end");
+            YCSB_LOG_DEBUG("Dump destination nodes info:");
+            for(auto dstNode : dstNodes){
+                dstNode->dump();
+            }
+            YCSB_LOG_DEBUG("Dump destination nodes end");
         }
-        pr_debug("Dump destination nodes end");
         // 正確的 internal key 哨兵
         
 
@@ -846,7 +857,7 @@ void API::compaction() {
             for (const auto& sp : dstNodes) if (sp) removeSSable(sp);
             for (const auto& sp : srcNodes) if (sp) removeSSable(sp);
         } else {
-            pr_debug("Compaction in level0 fail");
+            YCSB_LOG_ERROR("Compaction in level0 fail");
             return;
         }
     }
@@ -854,9 +865,11 @@ void API::compaction() {
     // ---------- Lk -> Lk+1 ----------
     for (int level = 1; level < MAX_LEVEL; ++level) {
         if (!compactionTrigger(level)) continue;
-        pr_debug("Compaction triggered at Level %d", level);
-        pr_debug("Compaction start tree info:");
-        lsmTree_->dump_lsmtere();
+        YCSB_LOG_DEBUG("Compaction triggered at Level %d", level);
+        if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)) {
+            YCSB_LOG_DEBUG("Compaction start tree info:");
+            lsmTree_->dump_lsmtere();
+        }
         compaction = true;
         
         auto &optKey = compaction_key_list_[level];
@@ -871,12 +884,14 @@ void API::compaction() {
         std::vector<std::shared_ptr<TreeNode>> srcNodes;
         srcNodes.push_back(srcNode);
         if (!srcNode) {
-            pr_debug("No next node at level %d", level);
+            YCSB_LOG_DEBUG("No next node at level %d", level);
             continue;
         }
 
-        pr_debug("Dump compaction source info:");
-        srcNode->dump();
+        if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)) {
+            YCSB_LOG_DEBUG("Dump compaction source info:");
+            srcNode->dump();
+        }
 
         auto dstNodes = getLSMTree()->search_one_level(level + 1, srcNode->rangeMin, srcNode->rangeMax);
 
@@ -914,8 +929,8 @@ void API::compaction() {
             removeSSable(srcNode);
         }
     }
-    if(compaction){
-        pr_debug("Compaction result:");
+    if(compaction && YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)){
+        YCSB_LOG_DEBUG("Compaction result:");
         lsmTree_->dump_lsmtere();
     }
     
@@ -927,8 +942,10 @@ void API::test(){
     auto node = getLSMTree()->findLevel0Older();
     if (!node) return;
 
-    pr_debug("Dump compaction source info:");
-    node->dump();
+    if (YCSB_LOG_ENABLED(YCSB_LOG_LEVEL_DEBUG)) {
+        YCSB_LOG_DEBUG("Dump compaction source info:");
+        node->dump();
+    }
 
     // 來源/目的候選：vector
     auto srcNodes = getLSMTree()->search_one_level(0, node->rangeMin, node->rangeMax);
@@ -1000,14 +1017,16 @@ void API::OnSSTableFlushed(const sstable_info& info) {
 
     if (immutable_memtable_) {
         immutable_memtable_.reset();
-        std::cout << "[API] Immutable memtable cleared after flush to " << info.filename << "\n";
+        YCSB_LOG_DEBUG("[API] Immutable memtable cleared after flush to %s",
+                       info.filename.c_str());
     }
 }
 
 void API::OnSSTableWriteFailed(const sstable_info& info, int err) {
     std::lock_guard<std::mutex> lk(mu_);
-    std::cerr << "[API] Flush failed for " << info.filename << ", err=" << err
-              << " (keeping immutable memtable for retry)\n";
+    YCSB_LOG_ERROR("[API] Flush failed for %s, err=%d "
+                   "(keeping immutable memtable for retry)",
+                   info.filename.c_str(), err);
 }
 
 
@@ -1017,26 +1036,26 @@ void API::log_garbage_collection(){
         uint32_t valid_offset = logManager_->get_first_block_offset();
         uint32_t lbn = logManager_->get_log_list_front();
         if(lbn >= LBN_NUM){
-            pr_debug("Invalid LBN for GC: %u", lbn);
+            YCSB_LOG_ERROR("Invalid LBN for GC: %u", lbn);
             break;
         }
         if(valid_offset >= BLOCK_SIZE){
-            pr_debug("Invalid offset for GC: %u", valid_offset);
+            YCSB_LOG_ERROR("Invalid offset for GC: %u", valid_offset);
             break;
         }
         uint32_t next_block_valid_offset = 0;
         auto records = logManager_->readLogBlock(lbn,valid_offset,next_block_valid_offset);
 
         if (next_block_valid_offset == UINT32_MAX) {
-            pr_debug("GC cross-page read failed for LBN %u; abort this GC cycle to avoid data loss", lbn);
+            YCSB_LOG_ERROR("GC cross-page read failed for LBN %u; abort this GC cycle to avoid data loss", lbn);
             break;
         }
         if (next_block_valid_offset >= BLOCK_SIZE) {
-            pr_debug("GC got invalid next_block_valid_offset=%u for LBN %u; abort", next_block_valid_offset, lbn);
+            YCSB_LOG_ERROR("GC got invalid next_block_valid_offset=%u for LBN %u; abort", next_block_valid_offset, lbn);
             break;
         }
         if (records.empty() && next_block_valid_offset == 0) {
-            pr_debug("GC readLogBlock returned empty for LBN %u (offset=%u); stop to avoid data loss",
+            YCSB_LOG_WARN("GC readLogBlock returned empty for LBN %u (offset=%u); stop to avoid data loss",
                      lbn, valid_offset);
             break;
         }
@@ -1046,16 +1065,16 @@ void API::log_garbage_collection(){
         Status s;
         for(const auto record : records){
             if (static_cast<uint8_t>(record.internal_key.info.type) == static_cast<uint8_t>(ValueType::kTypeDeletion)) {
-                pr_debug("GC skip tombstone key: %s", record.internal_key.UserKey().c_str());
+                YCSB_LOG_DEBUG("GC skip tombstone key: %s", record.internal_key.UserKey().c_str());
                 continue;
             }
             s = get(record.internal_key.UserKey(),rec);
             if(!s.ok()){
                 if(s.IsNotFound()){
-                    pr_debug("GC key: %s is deleted", record.internal_key.UserKey().c_str());
+                    YCSB_LOG_DEBUG("GC key: %s is deleted", record.internal_key.UserKey().c_str());
                     continue;
                 } else {
-                    pr_debug("Failed to get key: %s during GC", record.internal_key.UserKey().c_str());
+                    YCSB_LOG_ERROR("Failed to get key: %s during GC", record.internal_key.UserKey().c_str());
                     continue;
                 }
             }
@@ -1082,15 +1101,15 @@ void API::log_garbage_collection(){
                 rec.value_size                    == record.value_size;
 
             if (still_live) {
-                pr_info("GC rewrite live key: %s", record.internal_key.UserKey().c_str());
+                YCSB_LOG_DEBUG("GC rewrite live key: %s", record.internal_key.UserKey().c_str());
                 Status ps = put_from_gc(record.internal_key.UserKey(), record.value); // 或 std::move(record.value)
                 if (!ps.ok()) {
-                    pr_debug("GC put() failed for key: %s: %s",
+                    YCSB_LOG_ERROR("GC put() failed for key: %s: %s",
                             record.internal_key.UserKey().c_str(), ps.ToString().c_str());
                 }
             }
             else{
-                pr_debug("GC key: %s has newer version, skip", record.internal_key.UserKey().c_str());
+                YCSB_LOG_DEBUG("GC key: %s has newer version, skip", record.internal_key.UserKey().c_str());
             }
         }
         
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <iostream>
 #include "def.hh"
+#include "log.h"
 #include <algorithm>
 #include <memory>
 #include <optional>
@@ -15,12 +16,12 @@ LogManager::LogManager(INVMEDriver& nvme)
 void LogManager::allocate_lbn() {
     char *buffer = (char*)calloc(sizeof(uint32_t), 1);
     if (!buffer) {
-        std::cerr << "Buffer is null, cannot allocate LBN." << std::endl;
+        YCSB_LOG_ERROR("Buffer is null, cannot allocate LBN.");
         return;
     }
 
     if (nvme_.nvme_allcate_lbn(buffer) == COMMAND_FAILED) {
-        std::cerr << "Failed to allocate LBN." << std::endl;
+        YCSB_LOG_ERROR("Failed to allocate LBN.");
         free(buffer);
         return;
     }
@@ -47,7 +48,7 @@ void LogManager::flush_buffer()
     // pr_info("Flushing buffer to LPN: %lu", lpn);
     // printf("[FLUSH] th=%lu currentLPN=%u\n",pthread_self(), lpn);
     if (nvme_.nvme_write_log(lpn, aligned_page) == COMMAND_FAILED) {
-        std::cerr << "Failed to write log at LPN: " << lpn << '\n';
+        YCSB_LOG_ERROR("Failed to write log at LPN: %llu", (unsigned long long)lpn);
         return;
     }
 
@@ -90,11 +91,11 @@ void LogManager::writeLog(const Record& log)
 uint32_t LogManager::findNextLPN(uint32_t lpn) const{
     uint32_t currentLBN = LPN2LBN(lpn);
     size_t pageOffset   = lpn - LBN2LPN(currentLBN);
-    pr_info("Current LBN: %u, Page Offset: %zu", currentLBN, pageOffset);
+    YCSB_LOG_DEBUG("Current LBN: %u, Page Offset: %zu", currentLBN, pageOffset);
     if (pageOffset + 1 >= IMS_PAGE_NUM) {
         auto blkIt = std::find(logRecordBlock_.begin(), logRecordBlock_.end(), currentLBN);
         if (blkIt == logRecordBlock_.end() || ++blkIt == logRecordBlock_.end()) {
-            std::cerr << "[findNextLPN] No next block after LBN: " << currentLBN << '\n';
+            YCSB_LOG_ERROR("[findNextLPN] No next block after LBN: %u", currentLBN);
             return UINT32_MAX;
         }
 
@@ -113,7 +114,7 @@ std::optional<Record> LogManager::readLog(uint32_t lpn, uint32_t offset)
     auto readPage = [&](uint32_t lpn,char* buffer) -> bool{
         int err = nvme_.nvme_read_log(lpn,buffer);
         if(err == COMMAND_FAILED){
-            pr_debug("NNMe read log is failed");
+            YCSB_LOG_ERROR("NNMe read log is failed");
             return false;
         }
         return true;
@@ -123,7 +124,7 @@ std::optional<Record> LogManager::readLog(uint32_t lpn, uint32_t offset)
     uint32_t curLPN = lpn;
     uint32_t curOffset = offset;
     if (!read_buffer) {
-        std::cerr << "Failed to allocate read buffer." << std::endl;
+        YCSB_LOG_ERROR("Failed to allocate read buffer.");
         return std::nullopt;
     }
     
@@ -165,7 +166,7 @@ std::optional<Record> LogManager::readLog(uint32_t lpn, uint32_t offset)
     memcpy(&val_sz,result.data() + sizeof(uint32_t),sizeof(uint32_t));
     uint32_t blobSize = ikey_sz + val_sz;
     if (ikey_sz > 64) {
-        pr_debug("Reading log at LPN: %u, Offset: %u, Blob Size: %u (Key size: %u,value size: %u)", lpn, offset, blobSize,ikey_sz,val_sz);
+        YCSB_LOG_DEBUG("Reading log at LPN: %u, Offset: %u, Blob Size: %u (Key size: %u,value size: %u)", lpn, offset, blobSize,ikey_sz,val_sz);
         free(read_buffer);
         return std::nullopt;   
     }
@@ -207,7 +208,7 @@ std::vector<Record> LogManager::readLogBlock(uint32_t lbn,
     auto readBlock = [&](uint32_t lbn, char* buffer) -> bool {
         int err = nvme_.nvme_read_block(lbn, buffer);
         if (err == COMMAND_FAILED) {
-            pr_debug("NVMe read log failed at LBN %u (err=%d)", lbn, err);
+            YCSB_LOG_ERROR("NVMe read log failed at LBN %u (err=%d)", lbn, err);
             return false;
         }
         return true;
@@ -216,25 +217,25 @@ std::vector<Record> LogManager::readLogBlock(uint32_t lbn,
     std::vector<Record> results;
 
     if (lbn >= LBN_NUM) {
-        pr_debug("LBN %u is out of range (LBN_NUM=%u)", lbn, LBN_NUM);
+        YCSB_LOG_ERROR("LBN %u is out of range (LBN_NUM=%u)", lbn, LBN_NUM);
         nextBlockValidOffset = UINT32_MAX;
         return results;
     }
     if (valid_offset >= BLOCK_SIZE) {
-        pr_debug("Valid offset %u is out of range (BLOCK_SIZE=%u)", valid_offset, BLOCK_SIZE);
+        YCSB_LOG_ERROR("Valid offset %u is out of range (BLOCK_SIZE=%u)", valid_offset, BLOCK_SIZE);
         nextBlockValidOffset = UINT32_MAX;
         return results;
     }
 
     char* read_buffer = (char*)aligned_alloc(4096, BLOCK_SIZE);
     if (!read_buffer) {
-        std::cerr << "Failed to allocate read buffer." << std::endl;
+        YCSB_LOG_ERROR("Failed to allocate read buffer.");
         nextBlockValidOffset = UINT32_MAX;
         return results;
     }
 
     if (!readBlock(lbn, read_buffer)) {
-        pr_debug("Read block failed at LBN %u", lbn);
+        YCSB_LOG_ERROR("Read block failed at LBN %u", lbn);
         nextBlockValidOffset = UINT32_MAX;
         free(read_buffer);
         return results;
@@ -251,7 +252,7 @@ std::vector<Record> LogManager::readLogBlock(uint32_t lbn,
         std::memcpy(&val_sz,  read_buffer + curOffset + sizeof(uint32_t), sizeof(uint32_t));
 
         if (ikey_sz != 64) {
-            pr_debug("Invalid key size %u at LBN %u, Offset %zu", ikey_sz, lbn, curOffset);
+            YCSB_LOG_ERROR("Invalid key size %u at LBN %u, Offset %zu", ikey_sz, lbn, curOffset);
             nextBlockValidOffset = UINT32_MAX;
             break;
         }
@@ -261,7 +262,7 @@ std::vector<Record> LogManager::readLogBlock(uint32_t lbn,
                                 static_cast<size_t>(val_sz);
 
         if (curOffset + rec_size > BLOCK_SIZE) {
-            pr_debug("Record exceeds block boundary at LBN %u, Offset %zu", lbn, curOffset);
+            YCSB_LOG_ERROR("Record exceeds block boundary at LBN %u, Offset %zu", lbn, curOffset);
             nextBlockValidOffset = UINT32_MAX;
             break;
         }
@@ -289,7 +290,7 @@ std::vector<Record> LogManager::readLogBlock(uint32_t lbn,
 
             if (ikey_sz != 64) {
                 nextBlockValidOffset = UINT32_MAX;
-                pr_debug("Invalid key size %u at LPN %u, Offset %u", ikey_sz, curLPN, curOffsetInLPN);
+                YCSB_LOG_ERROR("Invalid key size %u at LPN %u, Offset %u", ikey_sz, curLPN, curOffsetInLPN);
             }
 
             
@@ -301,7 +302,7 @@ std::vector<Record> LogManager::readLogBlock(uint32_t lbn,
             
         } else {
             nextBlockValidOffset = UINT32_MAX;
-            pr_debug("Failed to read cross-page log at LPN %u, Offset %u", curLPN, curOffsetInLPN);
+            YCSB_LOG_ERROR("Failed to read cross-page log at LPN %u, Offset %u", curLPN, curOffsetInLPN);
         }
     }
     else{
@@ -2,6 +2,7 @@
 #include "def.hh"
 #include "internal_key.hh"
 #include "nvme_interface.hh"
+#include "log.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -23,7 +24,7 @@ AlignedBuf SstableManager::packingTable(const SkipList<Record, RecordComparator>
         case PackingType::kKeyRange:
             return keyRangePacking(skiplist);
         default:
-            pr_debug("PackingTable type is error");
+            YCSB_LOG_ERROR("PackingTable type is error");
             return {};
     }
 }
@@ -114,7 +115,7 @@ AlignedBuf SstableManager::keyHashPacking(const SkipList<Record, RecordComparato
         }
 
         if (!placed) {
-            pr_debug("Hash key is out of slot");
+            YCSB_LOG_ERROR("Hash key is out of slot");
             key.dump();
             throw std::runtime_error("Hash block full, cannot place key");
         }
@@ -168,7 +169,7 @@ AlignedBuf SstableManager::packingTable(std::queue<std::string> sortedLsit){
         case PackingType::kKeyRange:
             return keyRangePacking(sortedLsit);
         default:
-            pr_debug("PackingTable type is error");
+            YCSB_LOG_ERROR("PackingTable type is error");
             return {};
     }
 }
@@ -249,7 +250,7 @@ AlignedBuf SstableManager::keyHashPacking(std::queue<std::string> sortedList) co
         }
 
         if (!placed) {
-            pr_debug("Hash key is out of slot");
+            YCSB_LOG_ERROR("Hash key is out of slot");
             key.dump();
             throw std::runtime_error("Hash block full, cannot place key");
         }
@@ -315,7 +316,7 @@ void SstableManager::init() {}
 void SstableManager::readSSTable(const std::string& filename,char *buffer) {
     
     if (!buffer) {
-        std::cerr << "Failed to allocate buffer for reading SSTable\n";
+        YCSB_LOG_ERROR("Failed to allocate buffer for reading SSTable");
         return;
     }
 
@@ -332,18 +333,17 @@ void SstableManager::readSSTable(const std::string& filename,char *buffer) {
     // });
     int err = nvme_.nvme_read_sstable(filename, buffer);
     if (err == COMMAND_FAILED) {
-        std::cerr << "[Thread] Failed to read SSTable: " << filename << std::endl;
+        YCSB_LOG_ERROR("Failed to read SSTable: %s", filename.c_str());
         std::free(buffer);
         return;
     }
-    std::cout << "[Thread] Read success: " << filename << std::endl;
-    std::cout << "[Main] Async read dispatched.\n";
+    YCSB_LOG_DEBUG("Read success: %s", filename.c_str());
 }
 
 
 void SstableManager::writeSSTable(uint8_t level, InternalKey minKey, InternalKey maxKey, AlignedBuf sstable_buffer,bool clearImmuteTable) {
     if (sstable_buffer.ptr == nullptr) {
-        std::cerr << "SSTable buffer cannot be null" << std::endl;
+        YCSB_LOG_ERROR("SSTable buffer cannot be null");
         return;
     }
 
@@ -352,18 +352,17 @@ void SstableManager::writeSSTable(uint8_t level, InternalKey minKey, InternalKey
     std::string filename = generateFilename(sequenceNumber_.fetch_add(1));
 
     sstable_info info(filename, level, rangeMinKey, rangeMaxKey);
-    std::cout << "Dispatching write for SSTable: " << filename << std::endl;
-    info.dump();
+    YCSB_LOG_DEBUG("Dispatching write for SSTable: %s", filename.c_str());
 
     thread_pool_.Submit([info, buf = std::move(sstable_buffer), clearImmuteTable,this]() {
-        std::cout << "[Thread] Entered thread task\n";
         int err = nvme_.nvme_write_sstable(info,buf.data());
-        std::cout << "[Thread] nvme_write_sstable returned " << err << std::endl;
+        YCSB_LOG_DEBUG("[Thread] nvme_write_sstable returned %d", err);
         if (err == COMMAND_FAILED) {
-            pr_debug("[Thread] Failed to write SSTable: %s",info.filename);
+            YCSB_LOG_ERROR("[Thread] Failed to write SSTable: %s",
+                           info.filename.c_str());
             return;
         }
-        std::cout << "[Thread] Write success: " << info.filename << std::endl;
+        YCSB_LOG_DEBUG("[Thread] Write success: %s", info.filename.c_str());
 
         auto node = std::make_shared<TreeNode>(info.filename,
                                             info.level,
@@ -377,16 +376,16 @@ void SstableManager::writeSSTable(uint8_t level, InternalKey minKey, InternalKey
         if (clearImmuteTable) {
             notify_done(info);
         }
-        std::cout << "SStable(" << info.filename << ") written successfully.\n";
+        YCSB_LOG_DEBUG("SStable(%s) written successfully.",
+                       info.filename.c_str());
     });
 
-    std::cout << "[Main] Async write dispatched.\n";
 }
 
 // TODO
 void SstableManager::eraseSSTable(const std::string& filename) {
     if(filename.empty()){
-        pr_debug("DeleteSSTable filename is empty");
+        YCSB_LOG_ERROR("DeleteSSTable filename is empty");
         return;
     }
     int err = nvme_.nvme_erase_sstable(filename);
@@ -423,7 +422,7 @@ void SstableIterator::Seek(std::string_view internal_target) {
 
     // 如果你的 Decode 有 length 版，建议传长度；没有也可直接 memcpy 再比较对象
     if(internal_target.size() != kIKeySize) {
-        pr_debug("SStable iterator seek is error target");
+        YCSB_LOG_ERROR("SStable iterator seek is error target");
         pos_ = -1;
         return;
     }
@@ -456,7 +455,7 @@ Status SstableIterator::ReadValue(std::string& out) const {
     // pr_debug("Read LPN: %lu  ,Offset: %lu",ik.value_ptr.lpn, ik.value_ptr.offset);
     auto rec = log_mgr_->readLog(ik.value_ptr.lpn, ik.value_ptr.offset);
     if (!rec) {
-        pr_debug("ReadValue failed for key: %s", ik.UserKey().c_str());
+        YCSB_LOG_ERROR("ReadValue failed for key: %s", ik.UserKey().c_str());
         return Status::NotFound("value not found in log for key: " + ik.UserKey());
     }
     out = std::move(rec->value);
@@ -525,7 +524,7 @@ std::vector<SstableIterator::EntryRef> SstableIterator::gen_sorted_view() {
             break;
         }
         default:
-            pr_debug("Unknown packing type=%d", static_cast<int>(type_));
+            YCSB_LOG_ERROR("Unknown packing type=%d", static_cast<int>(type_));
             break;
     }
     return v;
@@ -557,9 +556,9 @@ void SstableManager::notify_done(const sstable_info& info) noexcept {
     try {
         on_write_done_(info);
     } catch (const std::exception& e) {
-        std::cerr << "[SstableManager] on_write_done_ threw: " << e.what() << "\n";
+        YCSB_LOG_ERROR("[SstableManager] on_write_done_ threw: %s", e.what());
     } catch (...) {
-        std::cerr << "[SstableManager] on_write_done_ threw unknown exception\n";
+        YCSB_LOG_ERROR("[SstableManager] on_write_done_ threw unknown exception");
     }
 }
 
@@ -568,8 +567,8 @@ void SstableManager::notify_fail(const sstable_info& info, int err) noexcept {
     try {
         on_write_fail_(info, err);
     } catch (const std::exception& e) {
-        std::cerr << "[SstableManager] on_write_fail_ threw: " << e.what() << "\n";
+        YCSB_LOG_ERROR("[SstableManager] on_write_fail_ threw: %s", e.what());
     } catch (...) {
-        std::cerr << "[SstableManager] on_write_fail_ threw unknown exception\n";
+        YCSB_LOG_ERROR("[SstableManager] on_write_fail_ threw unknown exception");
     }
 }
@@ -17,14 +17,11 @@ fi
 workload_dir=$1
 
 for file_name in $workload_dir/workload*.spec; do
-  for ((tn=1; tn<=8; tn=tn*2)); do
-    for db_name in ${db_names[@]}; do
-      for ((i=1; i<=repeat_num; ++i)); do
-        echo "Running $db_name with $tn threads for $file_name"
-        ./ycsbc -db $db_name -threads $tn -P $file_name 2>>ycsbc.output &
-        wait
-      done
-    done
+  for db_name in ${db_names[@]}; do
+    # Loads once, then runs every thread count $repeat_num times
+    echo "Running $db_name with 1-8 threads for $file_name"
+    ./ycsbc -db $db_name -P $file_name -p sweep.threads=1,2,4,8 \
+        -p sweep.repeats=$repeat_num 2>>ycsbc.output &
+    wait
   done
 done
-
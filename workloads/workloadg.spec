@@ -0,0 +1,28 @@
+# Yahoo! Cloud System Benchmark
+# Workload G: Insert/delete churn workload
+#   Application example: session or cache store expiring its oldest entries
+#                        as new ones arrive
+#
+#   Read/insert/delete ratio: 50/25/25
+#   Default data size: 1 KB records (10 fields, 100 bytes each, plus key)
+#   Request distribution: uniform
+#   Delete order: oldest first
+
+# Deletes keep pace with inserts, so the record count stays steady while the
+# DB accumulates tombstones. Reads increasingly land on deleted records and
+# are expected to find nothing; those count as succeeded.
+
+recordcount=100000
+operationcount=100000
+workload=com.yahoo.ycsb.workloads.CoreWorkload
+
+readallfields=true
+
+readproportion=0.5
+updateproportion=0
+scanproportion=0
+insertproportion=0.25
+deleteproportion=0.25
+
+requestdistribution=uniform
+deleteorder=oldest
@@ -0,0 +1,28 @@
+# Yahoo! Cloud System Benchmark
+# Workload H: Random delete workload
+#   Application example: user data store removing accounts and items
+#
+#   Read/update/insert/delete ratio: 40/30/15/15
+#   Default data size: 1 KB records (10 fields, 100 bytes each, plus key)
+#   Request distribution: zipfian
+#   Delete order: uniform
+
+# Deletes are spread over the whole key space, so tombstones are interleaved
+# with live records rather than clustered at the oldest keys.
+# A uniform delete may pick a record deleted before; finding nothing, it
+# counts as succeeded. Updates write deleted records back.
+
+recordcount=100000
+operationcount=100000
+workload=com.yahoo.ycsb.workloads.CoreWorkload
+
+readallfields=true
+
+readproportion=0.4
+updateproportion=0.3
+scanproportion=0
+insertproportion=0.15
+deleteproportion=0.15
+
+requestdistribution=zipfian
+deleteorder=uniform
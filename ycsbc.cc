@@ -6,16 +6,33 @@
 //  Copyright (c) 2014 Jinglei Ren <jinglei@ren.systems>.
 //
 
+#include <algorithm>
+#include <climits>
 #include <cstring>
 #include <string>
 #include <iostream>
 #include <vector>
+#include <functional>
 #include <future>
+#include <thread>
+#include <sys/prctl.h>
 #include "core/utils.h"
+#include "core/affinity.h"
 #include "core/timer.h"
+#include "core/async_client.h"
 #include "core/client.h"
 #include "core/core_workload.h"
+#include "core/measurements.h"
+#include "core/op_budget.h"
+#include "core/op_trace.h"
+#include "core/perf_counters.h"
+#include "core/replay_client.h"
+#include "core/results.h"
+#include "core/stats.h"
+#include "core/status_reporter.h"
+#include "core/trace_workload.h"
 #include "db/db_factory.h"
+#include "db/measured_db.h"
 #include <iostream>
 #include <iomanip>
 // #include <gem5/m5ops.h> 
@@ -24,20 +41,148 @@ using namespace std;
 
 void UsageMessage(const char *command);
 bool StrStartWith(const char *str, const char *pre);
-string ParseCommandLine(int argc, const char *argv[], utils::Properties &props);
+string ParseCommandLine(int argc, const char *argv[], utils::Properties &props,
+    vector<string> &phase_files);
+void LoadPropertyFile(const string &file_name, utils::Properties &props);
+
+///
+/// Creates the workload the properties ask for: operations replayed from
+/// an access log if tracefile is set, or else drawn from the generators.
+///
+ycsbc::CoreWorkload *CreateWorkload(const utils::Properties &props) {
+  ycsbc::CoreWorkload *wl;
+  if (props.GetProperty(ycsbc::TraceWorkload::TRACE_FILE_PROPERTY).empty()) {
+    wl = new ycsbc::CoreWorkload;
+  } else {
+    wl = new ycsbc::TraceWorkload;
+  }
+  wl->Init(props);
+  return wl;
+}
 
-int DelegateClient(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_ops,
-    bool is_loading) {
-  db->Init();
-  ycsbc::Client client(*db, *wl);
+///
+/// Issues operations until the budget is used up or, if deadline_ns is
+/// nonzero, until that time has passed.
+///
+int RunClient(ycsbc::Client &client, ycsbc::OpBudget *budget, bool is_loading,
+    double target_per_thread, uint64_t deadline_ns) {
+  if (target_per_thread > 0) {
+    // The default 50us timer slack would otherwise show up in every
+    // intended latency.
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+  }
+  const uint64_t start_ns = utils::NowNanos();
   int oks = 0;
-  for (int i = 0; i < num_ops; ++i) {
+  uint64_t left = 0;
+  for (uint64_t i = 0; ; ++i, --left) {
+    if (left == 0 && (left = budget->Claim()) == 0) break;
+    if (deadline_ns && utils::NowNanos() >= deadline_ns) break;
+    if (target_per_thread > 0) {
+      // Open loop: every operation has a fixed slot in the schedule,
+      // whether or not the previous ones completed in time.
+      uint64_t intended_ns = start_ns + (uint64_t)(i * 1e9 / target_per_thread);
+      utils::SleepUntilNanos(intended_ns);
+      client.set_intended_start(intended_ns);
+    }
     if (is_loading) {
       oks += client.DoInsert();
     } else {
       oks += client.DoTransaction();
     }
   }
+  return oks;
+}
+
+///
+/// Loads the records numbered [begin, end) in batches of batch_size,
+/// pacing whole batches under a target throughput.
+///
+int RunLoader(ycsbc::Client &client, uint64_t begin, uint64_t end,
+    int batch_size, double target_per_thread) {
+  if (target_per_thread > 0) {
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+  }
+  const uint64_t start_ns = utils::NowNanos();
+  int oks = 0;
+  for (uint64_t key = begin; key < end; key += batch_size) {
+    if (target_per_thread > 0) {
+      uint64_t intended_ns = start_ns +
+          (uint64_t)((key - begin) * 1e9 / target_per_thread);
+      utils::SleepUntilNanos(intended_ns);
+      client.set_intended_start(intended_ns);
+    }
+    oks += client.DoBatchInsert(key, std::min<uint64_t>(batch_size, end - key));
+  }
+  return oks;
+}
+
+int DelegateLoader(ycsbc::DB *db, ycsbc::CoreWorkload *wl, uint64_t begin,
+    uint64_t end, int batch_size, ycsbc::Measurements *measurements,
+    ycsbc::Measurements *intended_measurements, double target_per_thread) {
+  db->Init();
+  ycsbc::Client client(*db, *wl, measurements->NewThread(),
+      target_per_thread > 0 ? intended_measurements->NewThread() : NULL);
+  int oks = RunLoader(client, begin, end, batch_size, target_per_thread);
+  db->Close();
+  return oks;
+}
+
+int DelegateClient(ycsbc::DB *db, ycsbc::CoreWorkload *wl,
+    ycsbc::OpBudget *budget, bool is_loading, ycsbc::Measurements *measurements,
+    ycsbc::Measurements *intended_measurements, double target_per_thread,
+    uint64_t deadline_ns) {
+  db->Init();
+  ycsbc::Client client(*db, *wl, measurements->NewThread(),
+      target_per_thread > 0 ? intended_measurements->NewThread() : NULL);
+  int oks = RunClient(client, budget, is_loading, target_per_thread,
+                      deadline_ns);
+  db->Close();
+  return oks;
+}
+
+///
+/// Runs transactions as RunClient() does, keeping up to queue_depth of them
+/// in flight.
+///
+int DelegateAsyncClient(ycsbc::DB *db, ycsbc::CoreWorkload *wl,
+    ycsbc::OpBudget *budget, int queue_depth, ycsbc::Measurements *measurements,
+    ycsbc::Measurements *intended_measurements, double target_per_thread,
+    uint64_t deadline_ns) {
+  db->Init();
+  ycsbc::AsyncClient client(*db, *wl, queue_depth, measurements->NewThread(),
+      target_per_thread > 0 ? intended_measurements->NewThread() : NULL);
+  if (target_per_thread > 0) {
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+  }
+  const uint64_t start_ns = utils::NowNanos();
+  uint64_t left = 0;
+  for (uint64_t i = 0; ; ++i, --left) {
+    if (left == 0 && (left = budget->Claim()) == 0) break;
+    if (deadline_ns && utils::NowNanos() >= deadline_ns) break;
+    if (target_per_thread > 0) {
+      uint64_t intended_ns = start_ns + (uint64_t)(i * 1e9 / target_per_thread);
+      utils::SleepUntilNanos(intended_ns);
+      client.set_intended_start(intended_ns);
+    }
+    client.DoTransaction();
+  }
+  int oks = client.Drain();
+  db->Close();
+  return oks;
+}
+
+int DelegateReplayClient(ycsbc::DB *db, ycsbc::CoreWorkload *wl,
+    const ycsbc::TraceReader *trace, uint64_t begin, uint64_t end,
+    ycsbc::Measurements *measurements,
+    ycsbc::Measurements *intended_measurements, double target_per_thread,
+    uint64_t deadline_ns) {
+  db->Init();
+  ycsbc::ReplayClient client(*db, *wl, trace->header(),
+      trace->ops() + begin, trace->ops() + end, measurements->NewThread(),
+      target_per_thread > 0 ? intended_measurements->NewThread() : NULL);
+  // Each thread replays its own slice in order, so the budget is private
+  ycsbc::OpBudget budget(end - begin, max<uint64_t>(1, end - begin));
+  int oks = RunClient(client, &budget, false, target_per_thread, deadline_ns);
   db->Close();
   return oks;
 }
@@ -49,116 +194,537 @@ static inline struct timespec ts_sub(struct timespec a, struct timespec b){
   return d;
 }
 
+struct PhaseOptions {
+  int num_threads;
+  double target;          ///< Total operations per second, or 0 for no limit
+  double status_interval; ///< Seconds between status lines, or 0 for none
+  double max_seconds;     ///< Time limit of the phase, or 0 for none
+  int load_batch_size;    ///< Records per BatchInsert, or 0 for transactions
+  int queue_depth;        ///< Transactions in flight per thread
+  std::vector<int> cpus;  ///< CPU of each thread, or empty for no pinning
+  bool numa_local;        ///< Whether threads allocate on their own node
+  bool perf_counters;     ///< Whether threads count hardware events
+};
+
+///
+/// Starts fn on a thread of its own, pinned to cpu unless it is negative.
+/// The thread is placed before fn runs, so the client state fn creates is
+/// first touched, and thus allocated, on the thread's NUMA node. Unless
+/// perf is NULL, the hardware events fn causes are counted into it.
+///
+template <class F>
+future<int> StartThread(F fn, int cpu, bool numa_local,
+                        utils::PerfCounts *perf, vector<thread> &threads) {
+  packaged_task<int()> task([=]() {
+    if (cpu >= 0) utils::PinThisThread(cpu);
+    if (numa_local) utils::SetLocalAllocation();
+    if (!perf) return fn();
+    utils::PerfCounters counters;
+    counters.Start();
+    int oks = fn();
+    counters.Stop(*perf);
+    return oks;
+  });
+  future<int> result = task.get_future();
+  threads.emplace_back(move(task));
+  return result;
+}
 
-
-int main(const int argc, const char *argv[]) {
-  utils::Properties props;
-  string file_name = ParseCommandLine(argc, argv, props);
-
-  ycsbc::DB *db = ycsbc::DBFactory::CreateDB(props);
-  if (!db) {
-    cout << "Unknown database name " << props["dbname"] << endl;
-    exit(0);
+///
+/// Reads the options a transaction phase runs with from props; the time
+/// limit and load batch size are left to the caller.
+///
+PhaseOptions ReadPhaseOptions(const utils::Properties &props) {
+  PhaseOptions options;
+  options.num_threads = stoi(props.GetProperty("threadcount", "1"));
+  options.target = stod(props.GetProperty("target", "0"));
+  options.status_interval = stod(props.GetProperty("status.interval", "0"));
+  options.max_seconds = 0;
+  options.load_batch_size = 0;
+  options.queue_depth = stoi(props.GetProperty("queuedepth", "1"));
+  if (options.queue_depth < 1) {
+    throw utils::Exception("queuedepth must be positive");
   }
+  options.cpus = utils::ThreadCpus(props.GetProperty("affinity", ""),
+                                   options.num_threads);
+  options.numa_local = utils::StrToBool(props.GetProperty("numalocal",
+                                                          "false"));
+  options.perf_counters = utils::StrToBool(props.GetProperty("perfcounters",
+                                                             "false"));
+  return options;
+}
 
-  ycsbc::CoreWorkload wl;
-  wl.Init(props);
-
-  const int num_threads = stoi(props.GetProperty("threadcount", "1"));
-
-  // Loads data
+struct PhaseResult {
+  int oks;
+  uint64_t ops;          ///< Operations issued, whether or not they succeeded
+  unsigned long long ns; ///< Wall time from CLOCK_MONOTONIC
+  double duration;       ///< Wall time from PortableTimer
+  utils::PerfCounts perf; ///< Summed over the threads, if counted
+};
+
+///
+/// Runs total_ops operations, which threads claim in chunks as they go, or
+/// splits a trace evenly among the threads. A positive load_batch_size
+/// instead loads total_ops records, giving each thread a contiguous range
+/// of keys.
+///
+PhaseResult RunPhase(const string &name, ycsbc::DB *db,
+    ycsbc::CoreWorkload *wl, const ycsbc::TraceReader *trace, int total_ops,
+    const PhaseOptions &options, ycsbc::Measurements *measurements,
+    ycsbc::Measurements *intended_measurements) {
+  const int num_threads = options.num_threads;
+  const int load_batch_size = options.load_batch_size;
+  const double target = options.target;
+  if (trace) total_ops = trace->size();
+  const uint64_t first_key = load_batch_size > 0 ?
+      wl->ReserveSequenceKeyNums(total_ops) : 0;
+  ycsbc::OpBudget budget(total_ops,
+                        ycsbc::OpBudget::ChunkFor(total_ops, num_threads));
   vector<future<int>> actual_ops;
-  int total_ops = stoi(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]);
-  for (int i = 0; i < num_threads; ++i) {
-    actual_ops.emplace_back(async(launch::async,
-        DelegateClient, db, &wl, total_ops / num_threads, true));
-  }
-  assert((int)actual_ops.size() == num_threads);
-
-  int sum = 0;
-  for (auto &n : actual_ops) {
-    assert(n.valid());
-    sum += n.get();
-  }
-  cerr << "# Loading records:\t" << sum << endl;
-
-  // Peforms transactions
-  actual_ops.clear();
-  total_ops = stoi(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
+  vector<thread> threads;
+  vector<utils::PerfCounts> perf(options.perf_counters ? num_threads : 0);
 
   // utils::sanity_timer_200ms();
   // utils::PortableTimer::Sanity200ms();   // 打印一下；若仍为 0，说明只能走 fallback
   utils::PortableTimer timer;
   struct timespec t0{}, t1{};
-  if (clock_gettime(CLOCK_MONOTONIC, &t0) != 0) { perror("t0 clock_gettime"); return 1; }
+  if (clock_gettime(CLOCK_MONOTONIC, &t0) != 0) { perror("t0 clock_gettime"); exit(1); }
   // m5_reset_stats(0, 0);
-  // utils::MonotonicTimer timer;
   timer.Start();
+  const uint64_t deadline_ns = options.max_seconds > 0 ?
+      utils::NowNanos() + (uint64_t)(options.max_seconds * 1e9) : 0;
+  ycsbc::StatusReporter reporter(*measurements, name,
+                                 options.status_interval, cout);
   for (int i = 0; i < num_threads; ++i) {
-    actual_ops.emplace_back(async(launch::async,
-        DelegateClient, db, &wl, total_ops / num_threads, false));
+    const int cpu = options.cpus.empty() ? -1 : options.cpus[i];
+    utils::PerfCounts *thread_perf = perf.empty() ? NULL : &perf[i];
+    if (load_batch_size > 0) {
+      uint64_t begin = first_key + (uint64_t)total_ops * i / num_threads;
+      uint64_t end = first_key + (uint64_t)total_ops * (i + 1) / num_threads;
+      actual_ops.push_back(StartThread(bind(
+          DelegateLoader, db, wl, begin, end, load_batch_size,
+          measurements, intended_measurements, target / num_threads),
+          cpu, options.numa_local, thread_perf, threads));
+      continue;
+    }
+    if (trace) {
+      uint64_t begin = (uint64_t)total_ops * i / num_threads;
+      uint64_t end = (uint64_t)total_ops * (i + 1) / num_threads;
+      actual_ops.push_back(StartThread(bind(
+          DelegateReplayClient, db, wl, trace, begin, end,
+          measurements, intended_measurements, target / num_threads,
+          deadline_ns), cpu, options.numa_local, thread_perf, threads));
+      continue;
+    }
+    if (options.queue_depth > 1) {
+      actual_ops.push_back(StartThread(bind(
+          DelegateAsyncClient, db, wl, &budget,
+          options.queue_depth, measurements, intended_measurements,
+          target / num_threads, deadline_ns),
+          cpu, options.numa_local, thread_perf, threads));
+      continue;
+    }
+    actual_ops.push_back(StartThread(bind(
+        DelegateClient, db, wl, &budget, false,
+        measurements, intended_measurements, target / num_threads,
+        deadline_ns), cpu, options.numa_local, thread_perf, threads));
   }
-
-
-
-  // actual_ops.clear();
-  // total_ops = stoi(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
-  // utils::Timer timer;
-  // timer.Start();
-  // for (int i = 0; i < num_threads; ++i) {
-  //   actual_ops.emplace_back(async(launch::async,
-  //       DelegateClient, db, &wl, total_ops / num_threads, false));
-  // }
   assert((int)actual_ops.size() == num_threads);
 
-  sum = 0;
+  PhaseResult result;
+  result.oks = 0;
   for (auto &n : actual_ops) {
     assert(n.valid());
-    sum += n.get();
+    result.oks += n.get();
+  }
+  for (thread &t : threads) {
+    t.join();
   }
-  double duration = timer.End();
-  if (clock_gettime(CLOCK_MONOTONIC, &t1) != 0) { perror("t1 clock_gettime"); return 1; }
+  for (const utils::PerfCounts &counts : perf) {
+    result.perf.Add(counts);
+  }
+  // A load reports a batch as one operation, but issues every record in it
+  result.ops = load_batch_size > 0 ? total_ops : measurements->Count();
+  result.duration = timer.End();
+  if (clock_gettime(CLOCK_MONOTONIC, &t1) != 0) { perror("t1 clock_gettime"); exit(1); }
+  timespec d = ts_sub(t1, t0);
+  result.ns = (unsigned long long)d.tv_sec * 1000000000ull
+            + (unsigned long long)d.tv_nsec;
+  return result;
+}
 
+///
+/// Prints the hardware events a phase counted, per operation issued, as
+/// failed operations cost cycles too; does nothing if it counted none.
+///
+void PrintPerfCounts(const string &heading, const PhaseResult &result) {
+  const utils::PerfCounts &perf = result.perf;
+  if (perf.num_threads() == 0 || result.ops == 0) return;
+  cout << "# " << heading << endl;
+  cout << std::fixed << std::setprecision(3);
+  for (int e = 0; e < utils::kNumPerfEvents; ++e) {
+    if (!perf.valid(e)) continue;
+    cout << utils::PerfEventName(e) << "/op\t"
+         << (double)perf.count(e) / result.ops << endl;
+  }
+  if (perf.valid(utils::kPerfCycles) && perf.valid(utils::kPerfInstructions) &&
+      perf.count(utils::kPerfCycles) > 0) {
+    cout << "ipc\t" << (double)perf.count(utils::kPerfInstructions) /
+        perf.count(utils::kPerfCycles) << endl;
+  }
+}
 
-  auto ts_sub = [](timespec a, timespec b){
-    if ((a.tv_nsec -= b.tv_nsec) < 0) { a.tv_nsec += 1000000000; a.tv_sec -= 1; }
-    timespec d; d.tv_sec = a.tv_sec - b.tv_sec; d.tv_nsec = a.tv_nsec; return d;
-  };
-  timespec d = ts_sub(t1, t0);
-  unsigned long long ns = (unsigned long long)d.tv_sec * 1000000000ull
-                        + (unsigned long long)d.tv_nsec;
+///
+/// Prints the throughput of a measured transaction phase, in the tab
+/// separated form parse_result.py reads, followed by its latencies.
+///
+void PrintPhase(const string &name, const PhaseResult &result,
+    const utils::Properties &props, const string &file_name, int num_threads,
+    const ycsbc::Measurements &measurements,
+    const ycsbc::Measurements &intended_measurements, double target) {
+  const string suffix = (name == "RUN" ? "" : " " + name);
 
   // 强制浮点：不要用整数链式再乘/除
-  double secs = (double)ns / 1e9;
-  double ms   = (double)ns / 1e6;
-
+  double secs = (double)result.ns / 1e9;
 
-  std::cout << "time nano second=" << ns << std::endl;
+  std::cout << "time nano second=" << result.ns << std::endl;
 
   std::cout << std::fixed << std::setprecision(3)
-            << "elapsed_ms=" << (ns / 1000000.0) << " ";
+            << "elapsed_ms=" << (result.ns / 1000000.0) << " ";
   std::cout << std::fixed << std::setprecision(6)
-            << "duration_s=" << (ns / 1000000000.0) << "\n";
-
+            << "duration_s=" << (result.ns / 1000000000.0) << "\n";
 
   // 用同一个 secs 算吞吐，避免“两个计时器两个结果”
-  double ktps = (secs > 0.0) ? ( (double)sum / secs / 1000.0 ) : 0.0;
+  double ktps = (secs > 0.0) ? ( (double)result.oks / secs / 1000.0 ) : 0.0;
 
   // m5_dump_stats(0, 0);
-  // double ktps = (duration > 0.0) ? (static_cast<double>(sum) / duration / 1000.0) : 0.0;
 
   cerr.setf(std::ios::fixed);
   cerr.precision(3);
-  cerr << "# Transaction throughput (KTPS)\n";
+  cerr << "# Transaction throughput (KTPS)" << suffix << '\n';
   cerr << props["dbname"] << '\t' << file_name << '\t' << num_threads << '\t' << ktps << '\n';
 
-  cerr << "total_ops: " << sum << '\n';  // 打印“实际完成”的操作数
+  cerr << "total_ops: " << result.oks << '\n';  // 打印“实际完成”的操作数
   cerr.precision(6);
-  cerr << "duration: " << duration << " s\n";
+  cerr << "duration: " << result.duration << " s\n";
+
+  cout << "# Transaction latency" << suffix << endl;
+  measurements.Print(cout);
+  if (target > 0) {
+    cout << "# Transaction intended latency" << suffix << " (target "
+         << props["target"] << " ops/sec)" << endl;
+    intended_measurements.Print(cout);
+  }
+  PrintPerfCounts("Hardware counters per operation" + suffix, result);
+}
+
+///
+/// Prints and then discards what a measuredb wrapper recorded of the DB
+/// calls of the phase; does nothing for a DB without one.
+///
+void PrintDBCalls(ycsbc::DB *db, const string &heading) {
+  ycsbc::MeasuredDB *measured = dynamic_cast<ycsbc::MeasuredDB *>(db);
+  if (!measured) return;
+  cout << "# " << heading << endl;
+  measured->Print(cout);
+  measured->Reset();
+}
 
+///
+/// Parses sweep.threads, a comma-separated list of positive thread counts
+/// and ranges of them such as 1,2,4-8.
+///
+vector<int> ParseThreadCounts(const string &list) {
+  // A count is all digits, so that "-2" or "3a" is refused, not misread
+  auto parse_count = [](const string &str, int &count) {
+    string digits = utils::Trim(str);
+    if (digits.empty() || digits.size() > 9 ||
+        digits.find_first_not_of("0123456789") != string::npos) {
+      return false;
+    }
+    count = stoi(digits);
+    return count > 0;
+  };
+  vector<int> counts;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == string::npos) end = list.size();
+    string range = utils::Trim(list.substr(pos, end - pos));
+    pos = end + 1;
+    if (range.empty()) continue;
+    size_t dash = range.find('-');
+    int first = 0, last = 0;
+    bool valid = parse_count(range.substr(0, dash), first);
+    if (dash == string::npos) {
+      last = first;
+    } else {
+      valid = valid && parse_count(range.substr(dash + 1), last);
+    }
+    if (!valid || last < first) {
+      throw utils::Exception("Invalid sweep.threads entry \"" + range +
+          "\": expected a positive thread count or a range such as 4-8");
+    }
+    for (int n = first; n <= last; ++n) counts.push_back(n);
+  }
+  return counts;
 }
 
-string ParseCommandLine(int argc, const char *argv[], utils::Properties &props) {
+///
+/// Throughputs (KTPS) of the repeats of one phase at one thread count.
+///
+struct SweepPoint {
+  string phase;
+  int threads;
+  vector<double> ktps;
+};
+
+///
+/// Prints the statistics of every sweep point, with the outlier repeats,
+/// to stdout so that parse_result.py still sees only per-run lines.
+///
+void PrintSweep(const vector<SweepPoint> &points) {
+  std::ios::fmtflags flags = cout.flags();
+  std::streamsize precision = cout.precision();
+  cout << std::fixed << std::setprecision(3);
+  cout << "# Sweep throughput (KTPS)\n"
+       << "# phase\tthreads\trepeats\tmean\tstddev\tci95_low\tci95_high"
+       << "\toutliers\n";
+  for (const SweepPoint &p : points) {
+    utils::SampleStats s = utils::Summarize(p.ktps);
+    cout << p.phase << '\t' << p.threads << '\t' << s.n << '\t' << s.mean
+         << '\t' << s.stddev << '\t' << s.mean - s.ci95 << '\t'
+         << s.mean + s.ci95 << '\t';
+    bool any = false;
+    for (size_t i = 0; i < s.n; ++i) {
+      if (!s.outlier[i]) continue;
+      cout << (any ? "," : "") << '#' << i + 1 << '=' << p.ktps[i];
+      any = true;
+    }
+    cout << (any ? "" : "-") << '\n';
+  }
+  cout.flags(flags);
+  cout.precision(precision);
+}
+
+///
+/// Whether props, or any -phase file applied on top of them, may delete
+/// records: by a delete proportion, or by replaying a recorded trace.
+///
+bool MayDelete(const utils::Properties &props,
+               const vector<string> &phase_files) {
+  utils::Properties phase_props = props;
+  for (size_t i = 0; i <= phase_files.size(); ++i) {
+    if (i > 0) LoadPropertyFile(phase_files[i - 1], phase_props);
+    if (stod(phase_props.GetProperty(
+            ycsbc::CoreWorkload::DELETE_PROPORTION_PROPERTY,
+            ycsbc::CoreWorkload::DELETE_PROPORTION_DEFAULT)) > 0 ||
+        !phase_props.GetProperty(
+            ycsbc::TraceWorkload::TRACE_FILE_PROPERTY).empty() ||
+        !phase_props.GetProperty("optrace.replay").empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int main(const int argc, const char *argv[]) {
+  utils::Properties props;
+  vector<string> phase_files;
+  string file_name = ParseCommandLine(argc, argv, props, phase_files);
+
+  utils::SetRandomSeed(stoull(props.GetProperty("randomseed", "0")));
+
+  unique_ptr<ycsbc::CoreWorkload> wl(CreateWorkload(props));
+
+  const string trace_out = props.GetProperty("optrace.compile");
+  if (!trace_out.empty()) {
+    if (!props.GetProperty(ycsbc::TraceWorkload::TRACE_FILE_PROPERTY).empty()) {
+      throw utils::Exception("A tracefile workload cannot be compiled");
+    }
+    uint64_t num_ops = stoull(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
+    ycsbc::CompileTrace(*wl, num_ops, trace_out);
+    cerr << "# Compiled operations:\t" << num_ops << '\t' << trace_out << endl;
+    return 0;
+  }
+
+  if (props.GetProperty("recordlocks").empty()) {
+    props.SetProperty("recordlocks",
+                      MayDelete(props, phase_files) ? "true" : "false");
+  }
+  ycsbc::DB *db = ycsbc::DBFactory::CreateDB(props);
+  if (!db) {
+    cout << "Unknown database name " << props["dbname"] << endl;
+    exit(0);
+  }
+
+  PhaseOptions options = ReadPhaseOptions(props);
+  const int num_threads = options.num_threads;
+  const double target = options.target;
+
+  // Sweeps rerun each transaction phase per thread count and repeat,
+  // against the data loaded once
+  vector<int> sweep_threads =
+      ParseThreadCounts(props.GetProperty("sweep.threads"));
+  const int sweep_repeats = stoi(props.GetProperty("sweep.repeats", "1"));
+  if (sweep_repeats < 1) throw utils::Exception("sweep.repeats must be positive");
+  const bool sweeping = !sweep_threads.empty() || sweep_repeats > 1;
+  vector<SweepPoint> sweep;
+
+  // Checks the export settings up front rather than after a long run
+  const string export_file = props.GetProperty("export.file");
+  string export_format = props.GetProperty("export.format");
+  if (export_format.empty()) {
+    bool csv = export_file.size() >= 4 &&
+        export_file.compare(export_file.size() - 4, 4, ".csv") == 0;
+    export_format = csv ? "csv" : "json";
+  }
+  if (!ycsbc::RunResults::IsFormat(export_format)) {
+    throw utils::Exception("Unknown export.format " + export_format);
+  }
+  ycsbc::RunResults results(props);
+
+  // Loads data
+  ycsbc::Measurements load_measurements, load_intended_measurements;
+  PhaseOptions load_options = options;
+  load_options.load_batch_size = stoi(props.GetProperty("loadbatchsize", "1"));
+  if (load_options.load_batch_size < 1) {
+    throw utils::Exception("loadbatchsize must be positive");
+  }
+  PhaseResult loaded = RunPhase("LOAD", db, wl.get(), NULL,
+      stoi(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]), load_options,
+      &load_measurements, &load_intended_measurements);
+  cerr << "# Loading records:\t" << loaded.oks << endl;
+  cout << "# Loading latency" << endl;
+  load_measurements.Print(cout);
+  if (target > 0) {
+    cout << "# Loading intended latency (target " << props["target"]
+         << " ops/sec)" << endl;
+    load_intended_measurements.Print(cout);
+  }
+  PrintPerfCounts("Loading hardware counters per operation", loaded);
+  PrintDBCalls(db, "Loading DB calls");
+  results.AddPhase("LOAD", file_name, props, num_threads, loaded.oks,
+      loaded.ns / 1e9, load_measurements,
+      target > 0 ? &load_intended_measurements : NULL);
+
+  // Warms up with transactions whose statistics are discarded
+  const int warmup_ops = stoi(props.GetProperty("warmupoperationcount", "0"));
+  const double warmup_time = stod(props.GetProperty("warmuptime", "0"));
+  if (warmup_ops > 0 || warmup_time > 0) {
+    ycsbc::Measurements warmup_measurements, warmup_intended_measurements;
+    PhaseOptions warmup_options = options;
+    warmup_options.max_seconds = warmup_time;
+    PhaseResult warmed = RunPhase("WARMUP", db, wl.get(), NULL,
+        warmup_ops > 0 ? warmup_ops : INT_MAX, warmup_options,
+        &warmup_measurements, &warmup_intended_measurements);
+    cerr << "# Warm-up operations:\t" << warmed.oks << endl;
+    ycsbc::MeasuredDB *measured = dynamic_cast<ycsbc::MeasuredDB *>(db);
+    if (measured) measured->Reset();
+  }
+
+  // Peforms transactions: first as the command line configures them, then
+  // once more per -phase file applied on top, all against the same DB
+  vector<unique_ptr<ycsbc::CoreWorkload>> phase_workloads;
+  ycsbc::CoreWorkload *phase_wl = wl.get();
+  for (size_t i = 0; i <= phase_files.size(); ++i) {
+    utils::Properties phase_props = props;
+    string phase_name = "RUN";
+    string phase_file = file_name;
+    if (i > 0) {
+      phase_file = phase_files[i - 1];
+      phase_name += to_string(i + 1);
+      // Records are loaded once, before the first phase
+      utils::Properties file_props;
+      LoadPropertyFile(phase_file, file_props);
+      if (!file_props.GetProperty("loadbatchsize").empty()) {
+        throw utils::Exception(phase_file + ": loadbatchsize applies to "
+                               "loading only, not to a -phase file");
+      }
+      LoadPropertyFile(phase_file, phase_props);
+      // Continue the key space where the previous phase left it
+      string next_key = to_string(phase_wl->sequence_key_position());
+      phase_props.SetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY,
+                              next_key);
+      phase_props.SetProperty(ycsbc::CoreWorkload::INSERT_START_PROPERTY,
+                              next_key);
+      phase_workloads.emplace_back(CreateWorkload(phase_props));
+      phase_workloads.back()->InheritDeletes(*phase_wl);
+      phase_wl = phase_workloads.back().get();
+    }
+
+    unique_ptr<ycsbc::TraceReader> trace;
+    if (!phase_props.GetProperty("optrace.replay").empty()) {
+      trace.reset(new ycsbc::TraceReader(phase_props["optrace.replay"]));
+    }
+    PhaseOptions phase_options = ReadPhaseOptions(phase_props);
+    phase_options.max_seconds =
+        stod(phase_props.GetProperty("maxexecutiontime", "0"));
+    int phase_ops =
+        stoi(phase_props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
+    if (phase_ops <= 0 && phase_options.max_seconds > 0) {
+      phase_ops = INT_MAX; // Bounded by time only
+    }
+    const vector<int> phase_threads = sweep_threads.empty() ?
+        vector<int>(1, phase_options.num_threads) : sweep_threads;
+    if (sweeping && (stod(phase_props.GetProperty(
+            ycsbc::CoreWorkload::INSERT_PROPORTION_PROPERTY,
+            ycsbc::CoreWorkload::INSERT_PROPORTION_DEFAULT)) > 0 ||
+        stod(phase_props.GetProperty(
+            ycsbc::CoreWorkload::DELETE_PROPORTION_PROPERTY,
+            ycsbc::CoreWorkload::DELETE_PROPORTION_DEFAULT)) > 0)) {
+      YCSB_LOG_WARN("%s inserts or deletes records, so each sweep run starts "
+                    "from the records the previous one left",
+                    phase_name.c_str());
+    }
+    for (int threads : phase_threads) {
+      SweepPoint point = { phase_name, threads, vector<double>() };
+      phase_options.num_threads = threads;
+      phase_options.cpus = utils::ThreadCpus(
+          phase_props.GetProperty("affinity", ""), threads);
+      for (int r = 1; r <= sweep_repeats; ++r) {
+        string run_name = phase_name;
+        if (sweeping) {
+          run_name += " " + to_string(threads) + "t#" + to_string(r);
+        }
+        ycsbc::Measurements measurements, intended_measurements;
+        PhaseResult result = RunPhase(run_name, db, phase_wl, trace.get(),
+            phase_ops, phase_options, &measurements, &intended_measurements);
+        PrintPhase(run_name, result, phase_props, phase_file, threads,
+                   measurements, intended_measurements, phase_options.target);
+        PrintDBCalls(db, "DB calls " + run_name);
+        results.AddPhase(run_name, phase_file, phase_props, threads,
+            result.oks, result.ns / 1e9, measurements,
+            phase_options.target > 0 ? &intended_measurements : NULL);
+        point.ktps.push_back(result.ns ? result.oks / (result.ns / 1e6) : 0);
+      }
+      sweep.push_back(point);
+    }
+  }
+  if (sweeping) PrintSweep(sweep);
+
+  if (!export_file.empty()) {
+    results.Write(export_file, export_format);
+    cerr << "# Results written to:\t" << export_file << endl;
+  }
+}
+
+void LoadPropertyFile(const string &file_name, utils::Properties &props) {
+  ifstream input(file_name);
+  try {
+    props.Load(input);
+  } catch (const string &message) {
+    cout << message << endl;
+    exit(0);
+  } catch (const utils::Exception &e) {
+    cout << file_name << ": " << e.what() << endl;
+    exit(0);
+  }
+  input.close();
+}
+
+string ParseCommandLine(int argc, const char *argv[], utils::Properties &props,
+    vector<string> &phase_files) {
   int argindex = 1;
   string filename;
   while (argindex < argc && StrStartWith(argv[argindex], "-")) {
@@ -170,6 +736,14 @@ string ParseCommandLine(int argc, const char *argv[], utils::Properties &props)
       }
       props.SetProperty("threadcount", argv[argindex]);
       argindex++;
+    } else if (strcmp(argv[argindex], "-target") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        exit(0);
+      }
+      props.SetProperty("target", argv[argindex]);
+      argindex++;
     } else if (strcmp(argv[argindex], "-db") == 0) {
       argindex++;
       if (argindex >= argc) {
@@ -202,6 +776,19 @@ string ParseCommandLine(int argc, const char *argv[], utils::Properties &props)
       }
       props.SetProperty("slaves", argv[argindex]);
       argindex++;
+    } else if (strcmp(argv[argindex], "-p") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        exit(0);
+      }
+      const char *eq = strchr(argv[argindex], '=');
+      if (!eq) {
+        UsageMessage(argv[0]);
+        exit(0);
+      }
+      props.SetProperty(string(argv[argindex], eq - argv[argindex]), eq + 1);
+      argindex++;
     } else if (strcmp(argv[argindex], "-P") == 0) {
       argindex++;
       if (argindex >= argc) {
@@ -209,14 +796,15 @@ string ParseCommandLine(int argc, const char *argv[], utils::Properties &props)
         exit(0);
       }
       filename.assign(argv[argindex]);
-      ifstream input(argv[argindex]);
-      try {
-        props.Load(input);
-      } catch (const string &message) {
-        cout << message << endl;
+      LoadPropertyFile(filename, props);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-phase") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
         exit(0);
       }
-      input.close();
+      phase_files.push_back(argv[argindex]);
       argindex++;
     } else {
       cout << "Unknown option '" << argv[argindex] << "'" << endl;
@@ -236,9 +824,60 @@ void UsageMessage(const char *command) {
   cout << "Usage: " << command << " [options]" << endl;
   cout << "Options:" << endl;
   cout << "  -threads n: execute using n threads (default: 1)" << endl;
+  cout << "  -target n: attempt n operations per second in total, measuring latency" << endl;
+  cout << "             from each operation's scheduled start (default: unthrottled)" << endl;
   cout << "  -db dbname: specify the name of the DB to use (default: basic)" << endl;
   cout << "  -P propertyfile: load properties from the given file. Multiple files can" << endl;
   cout << "                   be specified, and will be processed in the order specified" << endl;
+  cout << "  -p name=value: set a property, overriding earlier property files" << endl;
+  cout << "                 (e.g. -p status.interval=1 to report every second)" << endl;
+  cout << "  -p randomseed=n: seed of the per-thread random streams (default: 0)" << endl;
+  cout << "  -phase propertyfile: after the transaction phase, run another one with" << endl;
+  cout << "                       this file applied on top of the other properties," << endl;
+  cout << "                       reusing the loaded DB. May be given several times" << endl;
+  cout << "Phase properties:" << endl;
+  cout << "  warmupoperationcount=n: run n transactions after loading and discard" << endl;
+  cout << "                          their statistics" << endl;
+  cout << "  warmuptime=sec: same, but stop after this many seconds" << endl;
+  cout << "  queuedepth=n: keep up to n transactions in flight per thread through" << endl;
+  cout << "                the DB's Async methods (default: 1, synchronous)" << endl;
+  cout << "  tracefile=f: replay operations from the access log f, one" << endl;
+  cout << "               \"op key [size [timestamp_us]]\" per line; see" << endl;
+  cout << "               core/trace_workload.h. trace.timestamps=true issues" << endl;
+  cout << "               them at their timestamps, trace.speedup=x x times faster" << endl;
+  cout << "  sweep.threads=list: after loading once, run each transaction phase" << endl;
+  cout << "                     with each thread count, e.g. 1,2,4-8" << endl;
+  cout << "  sweep.repeats=n: run each of those n times and summarize the" << endl;
+  cout << "                   throughput with mean, stddev, 95% CI and outliers" << endl;
+  cout << "  export.file=f: also write the results of the run to f" << endl;
+  cout << "  export.format=json|csv: layout of export.file, as described in" << endl;
+  cout << "                          README.md (default: from its extension)" << endl;
+  cout << "  maxexecutiontime=s: stop each transaction phase after s seconds;" << endl;
+  cout << "                      with operationcount=0, run for exactly s seconds" << endl;
+  cout << "  affinity=p: pin client threads to CPUs; p is compact (fill one NUMA" << endl;
+  cout << "              node first), scatter (alternate nodes) or a CPU list" << endl;
+  cout << "              such as 0-3,8 (default: no pinning)" << endl;
+  cout << "  numalocal=true: make client threads allocate on their own NUMA node" << endl;
+  cout << "  perfcounters=true: count cycles, instructions, LLC and branch misses" << endl;
+  cout << "                     and context switches of the client threads with" << endl;
+  cout << "                     perf_event_open, reported per operation" << endl;
+  cout << "  measuredb=true: also time every DB call per method and status, the" << endl;
+  cout << "                  read and write of a read-modify-write separately" << endl;
+  cout << "  striped.shards=n: number of shards of -db striped_stl (default: 64)" << endl;
+  cout << "  deleteproportion=x: fraction of transactions that delete a record;" << endl;
+  cout << "                      reads and deletes of a record already deleted" << endl;
+  cout << "                      count as succeeded when they find nothing" << endl;
+  cout << "  deleteorder=oldest|uniform: delete records in insertion order, or" << endl;
+  cout << "                              loaded ones at random (default: oldest)" << endl;
+  cout << "  loadbatchsize=n: insert records n at a time with DB::BatchInsert while" << endl;
+  cout << "                   loading; each thread loads a contiguous key range" << endl;
+  cout << "                   and batch latencies are reported as BATCHINSERT" << endl;
+  cout << "                   (default: 1)" << endl;
+  cout << "Trace properties:" << endl;
+  cout << "  optrace.compile=file: write operationcount transactions to a binary" << endl;
+  cout << "                        trace file and exit without running them" << endl;
+  cout << "  optrace.replay=file: replay a compiled trace as the transaction phase," << endl;
+  cout << "                       split evenly among the threads" << endl;
 }
 
 inline bool StrStartWith(const char *str, const char *pre) {